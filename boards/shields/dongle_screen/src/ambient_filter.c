@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/math_extras.h>
+
+#include "ambient_filter.h"
+
+#define MEDIAN_SIZE CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MEDIAN_SIZE
+#define EMA_SHIFT CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_EMA_SHIFT
+
+BUILD_ASSERT(MEDIAN_SIZE % 2 == 1, "DONGLE_SCREEN_AMBIENT_LIGHT_MEDIAN_SIZE must be odd");
+
+// --- Median of the last MEDIAN_SIZE readings, removes single spikes (e.g. a passing shadow) ---
+
+static int32_t median_ring[MEDIAN_SIZE];
+static uint8_t median_next;
+static uint8_t median_fill;
+
+static int32_t median_sample(int32_t raw)
+{
+    int32_t sorted[MEDIAN_SIZE];
+
+    median_ring[median_next] = raw;
+    median_next = (median_next + 1) % MEDIAN_SIZE;
+    median_fill = MIN(median_fill + 1, MEDIAN_SIZE);
+
+    // Insertion sort, the window is tiny
+    for (int i = 0; i < median_fill; i++)
+    {
+        int32_t value = median_ring[i];
+        int j = i;
+        for (; j > 0 && sorted[j - 1] > value; j--)
+        {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+    }
+
+    return sorted[median_fill / 2];
+}
+
+// --- Exponential moving average in Q8, smooths flicker, weight of a new reading 1/2^EMA_SHIFT ---
+
+static int32_t ema_q8;
+static bool ema_valid;
+static int32_t ema_input;
+
+static int32_t ema_sample(int32_t value)
+{
+    ema_input = value;
+
+    if (!ema_valid)
+    {
+        ema_q8 = value << 8;
+        ema_valid = true;
+    }
+    else
+    {
+        ema_q8 += ((value << 8) - ema_q8) >> EMA_SHIFT;
+    }
+
+    return (ema_q8 + 128) >> 8;
+}
+
+static bool ema_converged(void)
+{
+    int32_t ema = (ema_q8 + 128) >> 8;
+
+    return abs(ema - ema_input) <= MAX(1, ema_input / 32);
+}
+
+int32_t ambient_filter_sample(int32_t raw)
+{
+    return ema_sample(median_sample(raw));
+}
+
+uint32_t ambient_log2_q8(uint32_t value)
+{
+    uint32_t x = value + 1;
+    uint32_t integer = 31 - u32_count_leading_zeros(x);
+
+    // Mantissa in Q15 within [1.0, 2.0), the fractional bits are found by repeated squaring
+    uint32_t m = integer > 15 ? x >> (integer - 15) : x << (15 - integer);
+    uint32_t fraction = 0;
+
+    for (int bit = 7; bit >= 0; bit--)
+    {
+        m = (m * m) >> 15;
+        if (m >= (2 << 15))
+        {
+            m >>= 1;
+            fraction |= BIT(bit);
+        }
+    }
+
+    return (integer << 8) | fraction;
+}
+
+// --- Dwell-time hysteresis ---
+
+static uint8_t committed = 0xFF; // Invalid initial value to commit the first reading
+static bool pending = false;
+static int8_t pending_direction;
+static int64_t pending_since;
+
+bool ambient_hysteresis_update(uint8_t candidate, uint8_t threshold, int64_t now_ms,
+                               uint8_t *brightness)
+{
+    if (committed == 0xFF)
+    {
+        committed = candidate;
+        *brightness = candidate;
+        return true;
+    }
+
+    int diff = candidate - committed;
+    if (abs(diff) <= threshold)
+    {
+        // Back within the band, the change was spurious
+        pending = false;
+        return false;
+    }
+
+    int8_t direction = diff > 0 ? 1 : -1;
+    if (!pending || direction != pending_direction)
+    {
+        pending = true;
+        pending_direction = direction;
+        pending_since = now_ms;
+    }
+
+    if (now_ms - pending_since < CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_DWELL_MS)
+    {
+        return false;
+    }
+
+    pending = false;
+    committed = candidate;
+    *brightness = candidate;
+    return true;
+}
+
+bool ambient_filter_settling(void)
+{
+    return pending || (ema_valid && !ema_converged());
+}
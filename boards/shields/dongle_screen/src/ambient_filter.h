@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Feed a raw sensor reading through the median and EMA stages
+ * @return Filtered reading
+ */
+int32_t ambient_filter_sample(int32_t raw);
+
+/**
+ * @brief log2(value + 1) in Q8 fixed point, integer only
+ */
+uint32_t ambient_log2_q8(uint32_t value);
+
+/**
+ * @brief Dwell-time hysteresis on the brightness derived from the filtered reading
+ *
+ * A new brightness is only committed once it differs from the committed one by more than
+ * threshold for CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_DWELL_MS in the same direction. The first
+ * reading is committed right away.
+ *
+ * @return true if brightness holds a newly committed value
+ */
+bool ambient_hysteresis_update(uint8_t candidate, uint8_t threshold, int64_t now_ms,
+                               uint8_t *brightness);
+
+/**
+ * @brief Whether more readings are needed before the filters are settled, e.g. a change is
+ * waiting for its dwell time or the filters are still converging
+ */
+bool ambient_filter_settling(void);
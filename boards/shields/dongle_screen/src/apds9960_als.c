@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+
+#include "apds9960_als.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define APDS9960_NODE DT_INST(0, avago_apds9960)
+
+#define APDS9960_ENABLE_REG 0x80
+#define APDS9960_ENABLE_PON BIT(0)
+#define APDS9960_ENABLE_AEN BIT(1)
+#define APDS9960_ENABLE_PEN BIT(2)
+#define APDS9960_ENABLE_AIEN BIT(4)
+#define APDS9960_ENABLE_PIEN BIT(5)
+#define APDS9960_AILTL_REG 0x84 // AILTL, AILTH, AIHTL, AIHTH
+#define APDS9960_PILT_REG 0x89
+#define APDS9960_PIHT_REG 0x8B
+#define APDS9960_PERS_REG 0x8C
+#define APDS9960_PERS_APERS_MASK 0x0F
+#define APDS9960_PERS_PPERS_MASK 0xF0
+#define APDS9960_STATUS_REG 0x93
+#define APDS9960_STATUS_AINT BIT(4)
+#define APDS9960_STATUS_PINT BIT(5)
+#define APDS9960_AICLEAR_REG 0xE7 // Clears all non-gesture interrupts
+
+// Consecutive ALS cycles out of range before the interrupt fires, filters short flicker
+#define APDS9960_ALS_PERSISTENCE 2
+// Same for proximity, a single noisy reading shouldn't wake the screen
+#define APDS9960_PROX_PERSISTENCE 2
+
+static const struct i2c_dt_spec apds9960_i2c = I2C_DT_SPEC_GET(APDS9960_NODE);
+static apds9960_als_handler_t als_handler;
+static apds9960_als_handler_t prox_handler;
+
+static void apds9960_trigger_handler(const struct device *dev, const struct sensor_trigger *trigger)
+{
+    uint8_t status;
+
+    // Without the status every interrupt is treated as an ALS change, that only costs a reading
+    if (i2c_reg_read_byte_dt(&apds9960_i2c, APDS9960_STATUS_REG, &status) < 0)
+    {
+        status = APDS9960_STATUS_AINT;
+    }
+
+    // Release the interrupt line, the thresholds are re-armed after the new reading is evaluated
+    i2c_reg_write_byte_dt(&apds9960_i2c, APDS9960_AICLEAR_REG, 0);
+
+    if ((status & APDS9960_STATUS_PINT) && prox_handler)
+    {
+        prox_handler();
+    }
+    if ((status & APDS9960_STATUS_AINT) && als_handler)
+    {
+        als_handler();
+    }
+}
+
+int apds9960_als_trigger_init(const struct device *dev, apds9960_als_handler_t als,
+                              apds9960_als_handler_t prox)
+{
+    static const struct sensor_trigger trigger = {
+        .type = SENSOR_TRIG_THRESHOLD,
+        .chan = SENSOR_CHAN_PROX,
+    };
+
+    als_handler = als;
+    prox_handler = prox;
+
+    int rc = sensor_trigger_set(dev, &trigger, apds9960_trigger_handler);
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    // Registering the trigger enables the proximity interrupt, only the ALS interrupt is wanted
+    rc = i2c_reg_update_byte_dt(&apds9960_i2c, APDS9960_ENABLE_REG, APDS9960_ENABLE_PIEN, 0);
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    return i2c_reg_update_byte_dt(&apds9960_i2c, APDS9960_PERS_REG,
+                                  APDS9960_PERS_APERS_MASK | APDS9960_PERS_PPERS_MASK,
+                                  APDS9960_ALS_PERSISTENCE | (APDS9960_PROX_PERSISTENCE << 4));
+}
+
+int apds9960_als_arm(const struct device *dev, uint16_t low, uint16_t high)
+{
+    uint8_t thresholds[4];
+
+    sys_put_le16(low, &thresholds[0]);
+    sys_put_le16(high, &thresholds[2]);
+
+    int rc = i2c_burst_write_dt(&apds9960_i2c, APDS9960_AILTL_REG, thresholds, sizeof(thresholds));
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    rc = i2c_reg_write_byte_dt(&apds9960_i2c, APDS9960_AICLEAR_REG, 0);
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    uint8_t enable = APDS9960_ENABLE_PON | APDS9960_ENABLE_AEN | APDS9960_ENABLE_AIEN;
+    return i2c_reg_update_byte_dt(&apds9960_i2c, APDS9960_ENABLE_REG, enable, enable);
+}
+
+int apds9960_prox_arm(const struct device *dev, uint8_t threshold)
+{
+    // Low threshold 0 can't be undershot, only an approaching object interrupts
+    int rc = i2c_reg_write_byte_dt(&apds9960_i2c, APDS9960_PILT_REG, 0);
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    rc = i2c_reg_write_byte_dt(&apds9960_i2c, APDS9960_PIHT_REG, threshold);
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    uint8_t enable = APDS9960_ENABLE_PON | APDS9960_ENABLE_PEN | APDS9960_ENABLE_PIEN;
+    return i2c_reg_update_byte_dt(&apds9960_i2c, APDS9960_ENABLE_REG, enable, enable);
+}
+
+int apds9960_prox_disarm(const struct device *dev)
+{
+    // The proximity LED pulses draw most of the sensor current, keep it off while not needed
+    return i2c_reg_update_byte_dt(&apds9960_i2c, APDS9960_ENABLE_REG,
+                                  APDS9960_ENABLE_PEN | APDS9960_ENABLE_PIEN, 0);
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+/*
+ * ALS and proximity threshold interrupts of the APDS9960. The Zephyr driver only exposes the
+ * proximity threshold trigger, but its handler runs for every interrupt of the sensor, so the
+ * thresholds are programmed here directly and the interrupt source is read from STATUS.
+ */
+
+typedef void (*apds9960_als_handler_t)(void);
+
+/**
+ * @brief Register the interrupt handlers, called from the system work queue
+ *
+ * Both interrupts start disabled. @p prox_handler may be NULL when proximity isn't used.
+ */
+int apds9960_als_trigger_init(const struct device *dev, apds9960_als_handler_t als_handler,
+                              apds9960_als_handler_t prox_handler);
+
+/**
+ * @brief Arm the ALS interrupt for readings outside [low, high]
+ *
+ * Pending ALS interrupts are cleared. A bound of 0 (low) or UINT16_MAX (high) disables that side.
+ */
+int apds9960_als_arm(const struct device *dev, uint16_t low, uint16_t high);
+
+/**
+ * @brief Turn the proximity engine on and interrupt on readings above @p threshold
+ */
+int apds9960_prox_arm(const struct device *dev, uint8_t threshold);
+
+/**
+ * @brief Turn the proximity engine and its interrupt off again
+ */
+int apds9960_prox_disarm(const struct device *dev);
+
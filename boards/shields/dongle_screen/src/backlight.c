@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "backlight.h"
+#include "backlight_backend.h"
+#include "telemetry.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Cubic ease-in-out ("S-curve") sampled at t = i/64, scaled to 0..65535.
+// Starts slow, accelerates, then slows again to avoid abrupt changes in perceived brightness.
+#define EASE_LUT_SHIFT 10 // Q16 time -> 64 segments
+static const uint16_t ease_lut[65] = {
+    0, 1, 8, 27, 64, 125, 216, 343, 512,
+    729, 1000, 1331, 1728, 2197, 2744, 3375, 4096, 4913,
+    5832, 6859, 8000, 9261, 10648, 12167, 13824, 15625, 17576,
+    19683, 21952, 24389, 27000, 29791, 32768, 35744, 38535, 41146,
+    43583, 45852, 47959, 49910, 51711, 53368, 54887, 56274, 57535,
+    58676, 59703, 60622, 61439, 62160, 62791, 63338, 63807, 64204,
+    64535, 64806, 65023, 65192, 65319, 65410, 65471, 65508, 65527,
+    65534, 65535,
+};
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BRIGHTNESS_PERCEPTUAL)
+// CIE 1976 lightness L* = 0..100 to relative luminance, scaled to 0..65535.
+// Equal brightness steps then look equally large to the eye.
+static const uint16_t cie_lut[101] = {
+    0, 73, 145, 218, 290, 363, 435, 508, 580, 656,
+    738, 826, 922, 1024, 1134, 1251, 1376, 1509, 1650, 1800,
+    1959, 2127, 2304, 2491, 2687, 2894, 3111, 3338, 3576, 3826,
+    4087, 4359, 4643, 4940, 5248, 5569, 5903, 6251, 6611, 6985,
+    7373, 7775, 8192, 8623, 9069, 9530, 10006, 10498, 11006, 11530,
+    12071, 12628, 13202, 13793, 14401, 15027, 15671, 16333, 17014, 17713,
+    18431, 19168, 19924, 20700, 21497, 22313, 23149, 24007, 24885, 25784,
+    26705, 27648, 28612, 29598, 30607, 31639, 32694, 33771, 34872, 35997,
+    37146, 38319, 39516, 40738, 41986, 43258, 44555, 45879, 47228, 48603,
+    50005, 51434, 52890, 54372, 55883, 57421, 58987, 60581, 62203, 63855,
+    65535,
+};
+#endif
+
+// Eased progress for t in 0..65536, linearly interpolated between the table entries
+static uint32_t ease_in_out(uint32_t t)
+{
+    uint32_t idx = t >> EASE_LUT_SHIFT;
+    uint32_t frac = t & BIT_MASK(EASE_LUT_SHIFT);
+
+    if (idx >= ARRAY_SIZE(ease_lut) - 1)
+    {
+        return ease_lut[ARRAY_SIZE(ease_lut) - 1];
+    }
+    return ease_lut[idx] + (((ease_lut[idx + 1] - ease_lut[idx]) * frac) >> EASE_LUT_SHIFT);
+}
+
+// Brightness in 1/256 percent to PWM duty (0..BACKLIGHT_DUTY_MAX)
+static uint32_t level_to_duty(uint32_t level_q8)
+{
+    level_q8 = MIN(level_q8, 100 << 8);
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BRIGHTNESS_PERCEPTUAL)
+    uint32_t idx = level_q8 >> 8;
+    uint32_t frac = level_q8 & 0xFF;
+
+    if (idx >= 100)
+    {
+        return cie_lut[100];
+    }
+    return cie_lut[idx] + (((cie_lut[idx + 1] - cie_lut[idx]) * frac) >> 8);
+#else
+    return (level_q8 * BACKLIGHT_DUTY_MAX) / (100 << 8);
+#endif
+}
+
+// Levels of the ramp handed to the backend, so the real output level can be looked up from the
+// step the backend is playing. A plain set is stored as a ramp of one step.
+// The lock only covers this table, the backend is called after it is released: the software
+// backend ends up in an arbitrary PWM driver, which may block (I2C/SPI expanders). Callers
+// run on the brightness work queue, so the table and the backend can't be updated out of order.
+static int32_t ramp_levels[BACKLIGHT_RAMP_MAX_STEPS];
+static uint8_t ramp_count = 1;
+static struct k_spinlock ramp_lock;
+
+static int32_t current_level_q8(void)
+{
+    int step = backlight_backend_step();
+
+    if (step < 0 || step >= ramp_count)
+    {
+        step = ramp_count - 1;
+    }
+    return ramp_levels[step];
+}
+
+void backlight_set(uint8_t percent)
+{
+    uint16_t duty = level_to_duty(percent << 8);
+    k_spinlock_key_t key = k_spin_lock(&ramp_lock);
+
+    ramp_levels[0] = percent << 8;
+    ramp_count = 1;
+
+    k_spin_unlock(&ramp_lock, key);
+
+    backlight_backend_set(duty);
+    telemetry_backlight(duty, false);
+
+    LOG_INF("Screen brightness set to %d", percent);
+}
+
+uint32_t backlight_fade_to(uint8_t to)
+{
+    k_spinlock_key_t key = k_spin_lock(&ramp_lock);
+
+    // Start from what is actually shown, also when a running fade is interrupted
+    int32_t from_q8 = current_level_q8();
+    int32_t delta_q8 = (to << 8) - from_q8;
+    int diff = DIV_ROUND_UP(abs(delta_q8), 256);
+
+    // Skip animation entirely if brightness difference is too small
+    if (diff <= 1)
+    {
+        ramp_levels[0] = to << 8;
+        ramp_count = 1;
+        uint16_t duty = level_to_duty(ramp_levels[0]);
+        k_spin_unlock(&ramp_lock, key);
+
+        backlight_backend_set(duty);
+        telemetry_backlight(duty, false);
+        return 0;
+    }
+
+    // More steps for smoother fades over large differences
+    int steps = CLAMP(diff * 2, 6, BACKLIGHT_RAMP_MAX_STEPS - 1);
+
+    // Set total animation time: scale with difference but clamp between 500ms and 1000ms
+    int total_duration_ms = CLAMP(diff * 20, 500, 1000); // 20ms per level as baseline
+
+    struct backlight_ramp ramp = {
+        .count = steps + 1,
+        .step_us = (total_duration_ms * 1000) / steps,
+    };
+
+    // Interpolate in 1/256 percent, so the perceptual mapping gets intermediate levels as well
+    for (int i = 0; i <= steps; i++)
+    {
+        uint32_t t = (i << 16) / steps;
+        int32_t eased = ease_in_out(t);
+
+        ramp_levels[i] = from_q8 + (delta_q8 * eased) / BACKLIGHT_DUTY_MAX;
+        ramp.duty[i] = level_to_duty(ramp_levels[i]);
+    }
+    ramp_count = ramp.count;
+
+    k_spin_unlock(&ramp_lock, key);
+
+    // The backend adopts the new ramp within one step of the running one
+    backlight_backend_play(&ramp);
+
+    telemetry_backlight(ramp.duty[steps], true);
+    LOG_INF("Screen brightness fading from %d to %d", from_q8 >> 8, to);
+    return (ramp.count * ramp.step_us) / USEC_PER_MSEC;
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Set the backlight immediately
+ * @param percent Brightness 0-100, mapped to the PWM duty through the perceptual curve
+ */
+void backlight_set(uint8_t percent);
+
+/**
+ * @brief Fade the backlight from its current output level with an ease-in-out curve
+ *
+ * A running fade is interrupted and the new one starts from the level actually shown.
+ *
+ * @return Duration of the fade in milliseconds, 0 if the level was set immediately
+ */
+uint32_t backlight_fade_to(uint8_t to);
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/pwm.h>
+
+#define BACKLIGHT_PWM_NODE DT_NODELABEL(disp_bl)
+
+// Duty cycles are given as 0..BACKLIGHT_DUTY_MAX of the PWM period
+#define BACKLIGHT_DUTY_MAX 65535
+
+// One entry for the start level plus up to 32 fade steps
+#define BACKLIGHT_RAMP_MAX_STEPS 33
+
+/**
+ * @brief Precomputed fade, every duty value is held for step_us
+ */
+struct backlight_ramp
+{
+    uint16_t duty[BACKLIGHT_RAMP_MAX_STEPS];
+    uint8_t count;
+    uint32_t step_us;
+};
+
+/*
+ * Implemented by exactly one backend (CONFIG_DONGLE_SCREEN_BACKLIGHT_BACKEND_*):
+ * software stepping, nRF PWM sequence playback or the native_sim stub.
+ */
+
+/**
+ * @brief Set the duty cycle, stopping a running ramp
+ */
+void backlight_backend_set(uint16_t duty);
+
+/**
+ * @brief Start playing a ramp. A running ramp is replaced within one of its steps, the new
+ * ramp is expected to start at the level currently shown. The ramp is copied.
+ */
+void backlight_backend_play(const struct backlight_ramp *ramp);
+
+/**
+ * @brief Index of the ramp step currently shown, -1 if no ramp is playing
+ */
+int backlight_backend_step(void);
+
+static inline uint32_t backlight_duty_to_pulse(const struct pwm_dt_spec *spec, uint16_t duty)
+{
+    return ((uint64_t)spec->period * duty) / BACKLIGHT_DUTY_MAX;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/logging/log.h>
+#include <nrfx.h>
+#include <hal/nrf_pwm.h>
+#include <hal/nrf_gpio.h>
+
+#include "backlight_backend.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Hardware fade playback: the ramp is handed to the PWM peripheral as a sequence, EasyDMA loads
+// one value per step and the REFRESH counter holds it for the step duration. The CPU only wakes
+// up once at the end of the ramp to hand the peripheral back to the PWM driver, which then
+// knows the final duty again and may stop the PWM for 0 %.
+
+#define BACKLIGHT_PWM_CTLR DT_PWMS_CTLR(BACKLIGHT_PWM_NODE)
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(BACKLIGHT_PWM_CTLR, nordic_nrf_pwm),
+             "The nRF PWM backlight backend needs disp_bl on a nordic,nrf-pwm controller");
+
+// Same encoding as the pwm_nrfx driver: bit 15 set = normal polarity
+#define SEQ_POLARITY_NORMAL BIT(15)
+
+static const struct pwm_dt_spec backlight_pwm = PWM_DT_SPEC_GET(BACKLIGHT_PWM_NODE);
+static NRF_PWM_Type *const pwm_regs = (NRF_PWM_Type *)DT_REG_ADDR(BACKLIGHT_PWM_CTLR);
+
+// The individual decoder takes one value per channel and step. Two buffers, so a new ramp is
+// never written into the one EasyDMA is still reading.
+static uint16_t seq_values[2][BACKLIGHT_RAMP_MAX_STEPS * NRF_PWM_CHANNEL_COUNT];
+static uint8_t seq_active;
+static uint16_t seq_polarity;
+static uint16_t ramp_final_duty;
+static uint8_t ramp_count;
+static int64_t ramp_start_us;
+static uint32_t ramp_step_us;
+
+static void ramp_end_work_handler(struct k_work *work)
+{
+    pwm_set_pulse_dt(&backlight_pwm, backlight_duty_to_pulse(&backlight_pwm, ramp_final_duty));
+}
+
+static K_WORK_DELAYABLE_DEFINE(ramp_end_work, ramp_end_work_handler);
+
+void backlight_backend_set(uint16_t duty)
+{
+    k_work_cancel_delayable(&ramp_end_work);
+    pwm_set_pulse_dt(&backlight_pwm, backlight_duty_to_pulse(&backlight_pwm, duty));
+}
+
+// Compare words (polarity and duty) the channels of the instance currently play, NULL if the
+// peripheral was never started
+static const uint16_t *current_channel_words(void)
+{
+    if (k_work_delayable_is_pending(&ramp_end_work))
+    {
+        // Other channels hold the same word in every step of a running ramp
+        return seq_values[seq_active];
+    }
+
+    // Otherwise the driver owns the peripheral and plays its own buffer through sequence 0
+    const uint16_t *words = (const uint16_t *)pwm_regs->SEQ[0].PTR;
+    return nrfx_is_in_ram(words) ? words : NULL;
+}
+
+void backlight_backend_play(const struct backlight_ramp *ramp)
+{
+    // The driver has already programmed prescaler and COUNTERTOP for the devicetree period
+    uint32_t top = pwm_regs->COUNTERTOP;
+    uint32_t periods = MAX(((uint64_t)ramp->step_us * NSEC_PER_USEC) / backlight_pwm.period, 1);
+    uint8_t seq = seq_active ^ 1;
+    uint16_t *values = seq_values[seq];
+    const uint16_t *current = current_channel_words();
+    uint16_t words[NRF_PWM_CHANNEL_COUNT];
+
+    // Other channels of the instance keep their duty and polarity during the fade
+    for (int channel = 0; channel < NRF_PWM_CHANNEL_COUNT; channel++)
+    {
+        words[channel] = current ? current[channel] : seq_polarity;
+    }
+
+    for (int i = 0; i < ramp->count; i++)
+    {
+        uint16_t compare = ((uint32_t)top * ramp->duty[i]) / BACKLIGHT_DUTY_MAX;
+
+        words[backlight_pwm.channel] = seq_polarity | compare;
+        memcpy(&values[i * NRF_PWM_CHANNEL_COUNT], words, sizeof(words));
+    }
+
+    k_work_cancel_delayable(&ramp_end_work);
+
+    nrf_pwm_enable(pwm_regs);
+    nrf_pwm_decoder_set(pwm_regs, NRF_PWM_LOAD_INDIVIDUAL, NRF_PWM_STEP_AUTO);
+    nrf_pwm_seq_ptr_set(pwm_regs, seq, values);
+    nrf_pwm_seq_cnt_set(pwm_regs, seq, ramp->count * NRF_PWM_CHANNEL_COUNT);
+    nrf_pwm_seq_refresh_set(pwm_regs, seq, periods - 1);
+    nrf_pwm_seq_end_delay_set(pwm_regs, seq, 0);
+    nrf_pwm_loop_set(pwm_regs, 0);
+    // No shortcuts: after the last step the peripheral keeps generating the last value
+    nrf_pwm_shorts_set(pwm_regs, 0);
+    nrf_pwm_task_trigger(pwm_regs, seq ? NRF_PWM_TASK_SEQSTART1 : NRF_PWM_TASK_SEQSTART0);
+    seq_active = seq;
+
+    ramp_final_duty = ramp->duty[ramp->count - 1];
+    ramp_count = ramp->count;
+    ramp_step_us = ((uint64_t)periods * backlight_pwm.period) / NSEC_PER_USEC;
+    ramp_start_us = k_ticks_to_us_floor64(k_uptime_ticks());
+    k_work_schedule(&ramp_end_work, K_USEC(ramp_count * ramp_step_us));
+}
+
+// Runs after the PWM driver is initialized but before the first brightness is set, while the
+// pin still shows the idle level pinctrl configured
+static int backlight_nrf_pwm_init(void)
+{
+    uint32_t psel = pwm_regs->PSEL.OUT[backlight_pwm.channel];
+    bool inverted = backlight_pwm.flags & PWM_POLARITY_INVERTED;
+
+    // A high idle level (nordic,invert) inverts the channel, as in the pwm_nrfx driver
+    if ((psel & PWM_PSEL_OUT_CONNECT_Msk) == 0 &&
+        nrf_gpio_pin_out_read(psel & ~PWM_PSEL_OUT_CONNECT_Msk))
+    {
+        inverted = !inverted;
+    }
+    seq_polarity = inverted ? 0 : SEQ_POLARITY_NORMAL;
+
+    return 0;
+}
+
+SYS_INIT(backlight_nrf_pwm_init, POST_KERNEL, CONFIG_APPLICATION_INIT_PRIORITY);
+
+int backlight_backend_step(void)
+{
+    if (!k_work_delayable_is_pending(&ramp_end_work))
+    {
+        return -1;
+    }
+
+    // The peripheral plays on its own, so the position is derived from the elapsed time
+    int64_t elapsed_us = k_ticks_to_us_floor64(k_uptime_ticks()) - ramp_start_us;
+    return MIN(elapsed_us / ramp_step_us, ramp_count - 1);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/logging/log.h>
+
+#include "backlight_backend.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// native_sim stub: ramps are not stepped, the final duty is applied once the ramp would have
+// finished, like the hardware playback backend does. Every ramp is logged for inspection.
+
+static const struct pwm_dt_spec backlight_pwm = PWM_DT_SPEC_GET(BACKLIGHT_PWM_NODE);
+
+static uint16_t ramp_final_duty;
+static uint8_t ramp_count;
+static int64_t ramp_start_us;
+static uint32_t ramp_step_us;
+
+static void ramp_end_work_handler(struct k_work *work)
+{
+    pwm_set_pulse_dt(&backlight_pwm, backlight_duty_to_pulse(&backlight_pwm, ramp_final_duty));
+}
+
+static K_WORK_DELAYABLE_DEFINE(ramp_end_work, ramp_end_work_handler);
+
+void backlight_backend_set(uint16_t duty)
+{
+    k_work_cancel_delayable(&ramp_end_work);
+    pwm_set_pulse_dt(&backlight_pwm, backlight_duty_to_pulse(&backlight_pwm, duty));
+}
+
+void backlight_backend_play(const struct backlight_ramp *ramp)
+{
+    LOG_DBG("Backlight ramp: %d steps of %d us, duty %d -> %d", ramp->count, ramp->step_us,
+            ramp->duty[0], ramp->duty[ramp->count - 1]);
+
+    ramp_final_duty = ramp->duty[ramp->count - 1];
+    ramp_count = ramp->count;
+    ramp_step_us = MAX(ramp->step_us, 1);
+    ramp_start_us = k_ticks_to_us_floor64(k_uptime_ticks());
+    k_work_reschedule(&ramp_end_work, K_USEC(ramp_count * ramp_step_us));
+}
+
+int backlight_backend_step(void)
+{
+    if (!k_work_delayable_is_pending(&ramp_end_work))
+    {
+        return -1;
+    }
+
+    // The peripheral plays on its own, so the position is derived from the elapsed time
+    int64_t elapsed_us = k_ticks_to_us_floor64(k_uptime_ticks()) - ramp_start_us;
+    return MIN(elapsed_us / ramp_step_us, ramp_count - 1);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+#include "backlight_backend.h"
+#include "brightness.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Software fallback for PWM controllers without sequence playback: every ramp step is set
+// through the PWM API from a delayable work item on the brightness work queue.
+
+static const struct pwm_dt_spec backlight_pwm = PWM_DT_SPEC_GET(BACKLIGHT_PWM_NODE);
+
+// Only the most recent ramp is kept, a new one restarts the work item at its first step
+static struct backlight_ramp ramp;
+static uint8_t ramp_next;
+static struct k_spinlock ramp_lock;
+static atomic_t ramp_step = ATOMIC_INIT(-1);
+
+static void ramp_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(ramp_work, ramp_work_handler);
+
+static void ramp_work_handler(struct k_work *work)
+{
+    k_spinlock_key_t key = k_spin_lock(&ramp_lock);
+
+    if (ramp_next >= ramp.count)
+    {
+        // The last step has been shown for a full step period
+        atomic_set(&ramp_step, -1);
+        k_spin_unlock(&ramp_lock, key);
+        return;
+    }
+
+    uint16_t duty = ramp.duty[ramp_next];
+    uint32_t step_us = ramp.step_us;
+    atomic_set(&ramp_step, ramp_next++);
+    k_spin_unlock(&ramp_lock, key);
+
+    pwm_set_pulse_dt(&backlight_pwm, backlight_duty_to_pulse(&backlight_pwm, duty));
+
+    // Doesn't move the deadline when a new ramp already rescheduled the work item
+    k_work_schedule_for_queue(brightness_work_q(), &ramp_work, K_USEC(step_us));
+}
+
+void backlight_backend_set(uint16_t duty)
+{
+    struct backlight_ramp single = {.duty = {duty}, .count = 1};
+
+    // Routed through the work item, so a running ramp can't overwrite the value afterwards
+    backlight_backend_play(&single);
+}
+
+void backlight_backend_play(const struct backlight_ramp *new_ramp)
+{
+    k_spinlock_key_t key = k_spin_lock(&ramp_lock);
+    ramp = *new_ramp;
+    ramp_next = 0;
+    // The first step of the new ramp is the level currently shown
+    atomic_set(&ramp_step, 0);
+    k_spin_unlock(&ramp_lock, key);
+
+    k_work_reschedule_for_queue(brightness_work_q(), &ramp_work, K_NO_WAIT);
+}
+
+int backlight_backend_step(void)
+{
+    return atomic_get(&ramp_step);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/split/central.h>
+
+#include "battery_history.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Dongle plus all peripherals, the dongle battery may not be shown but keeps the indices simple
+#define BATTERY_HISTORY_SOURCES (ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT + 1)
+#define BATTERY_HISTORY_SIZE CONFIG_DONGLE_SCREEN_BATTERY_HISTORY_SIZE
+#define BATTERY_HISTORY_MS_PER_MIN (60 * 1000)
+// Rises by more than this are charging, smaller ones are measurement noise
+#define BATTERY_HISTORY_CHARGE_STEP 1
+#define BATTERY_HISTORY_MIN_SAMPLES 3
+
+// Samples are stored as level and minutes since the previous sample. The least-squares sums
+// over (t, level) are updated with every sample added or dropped, t counts minutes from the
+// oldest sample in the window, so the sums stay small however long the dongle runs.
+struct battery_history
+{
+    uint8_t level[BATTERY_HISTORY_SIZE];
+    uint16_t dt_min[BATTERY_HISTORY_SIZE];
+    uint8_t head; // Oldest sample
+    uint8_t count;
+    uint32_t t_newest;
+    int64_t newest_ms; // Uptime of the newest sample, advanced in whole minutes
+    int64_t sum_t;
+    int64_t sum_y;
+    int64_t sum_tt;
+    int64_t sum_ty;
+};
+
+static struct battery_history histories[BATTERY_HISTORY_SOURCES];
+
+static void battery_history_push(struct battery_history *h, uint8_t level, uint16_t dt_min)
+{
+    int idx = (h->head + h->count) % BATTERY_HISTORY_SIZE;
+    int64_t t = h->count > 0 ? h->t_newest + dt_min : 0;
+
+    h->level[idx] = level;
+    h->dt_min[idx] = dt_min;
+    h->count++;
+    h->t_newest = t;
+
+    h->sum_t += t;
+    h->sum_y += level;
+    h->sum_tt += t * t;
+    h->sum_ty += t * level;
+}
+
+static void battery_history_drop_oldest(struct battery_history *h)
+{
+    // The oldest sample is at t = 0, it only contributes to the level sum
+    h->sum_y -= h->level[h->head];
+    h->head = (h->head + 1) % BATTERY_HISTORY_SIZE;
+    h->count--;
+
+    // Move the origin to the new oldest sample
+    int64_t d = h->dt_min[h->head];
+    h->sum_tt += -2 * d * h->sum_t + h->count * d * d;
+    h->sum_ty -= d * h->sum_y;
+    h->sum_t -= h->count * d;
+    h->t_newest -= d;
+}
+
+void battery_history_add(uint8_t source, uint8_t level)
+{
+    if (source >= BATTERY_HISTORY_SOURCES || level < 1)
+    {
+        return;
+    }
+
+    struct battery_history *h = &histories[source];
+    int64_t now = k_uptime_get();
+
+    if (h->count > 0)
+    {
+        uint8_t newest = h->level[(h->head + h->count - 1) % BATTERY_HISTORY_SIZE];
+        int64_t dt_min = (now - h->newest_ms) / BATTERY_HISTORY_MS_PER_MIN;
+
+        if (level <= newest + BATTERY_HISTORY_CHARGE_STEP && dt_min <= UINT16_MAX)
+        {
+            if (h->count == BATTERY_HISTORY_SIZE)
+            {
+                battery_history_drop_oldest(h);
+            }
+            battery_history_push(h, level, dt_min);
+            h->newest_ms += dt_min * BATTERY_HISTORY_MS_PER_MIN;
+            return;
+        }
+
+        LOG_DBG("Battery history of source %d restarted (%d -> %d)", source, newest, level);
+    }
+
+    *h = (struct battery_history){.newest_ms = now};
+    battery_history_push(h, level, 0);
+}
+
+int32_t battery_history_remaining_min(uint8_t source)
+{
+    if (source >= BATTERY_HISTORY_SOURCES || histories[source].count < BATTERY_HISTORY_MIN_SAMPLES)
+    {
+        return -1;
+    }
+
+    const struct battery_history *h = &histories[source];
+    int64_t n = h->count;
+
+    // Slope is num / den in level per minute
+    int64_t num = n * h->sum_ty - h->sum_t * h->sum_y;
+    int64_t den = n * h->sum_tt - h->sum_t * h->sum_t;
+    if (den <= 0 || num >= 0)
+    {
+        return -1;
+    }
+
+    // The fitted line reaches 0 at t0 = -intercept / slope
+    int64_t t0 = (h->sum_y * den - num * h->sum_t) / (n * -num);
+    int64_t remaining = t0 - h->t_newest - (k_uptime_get() - h->newest_ms) / BATTERY_HISTORY_MS_PER_MIN;
+
+    return CLAMP(remaining, 0, INT32_MAX);
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Record a changed battery level of a source, 0 (asleep) is ignored
+ *
+ * A rise is taken as charging and restarts the history of the source.
+ */
+void battery_history_add(uint8_t source, uint8_t level);
+
+/**
+ * @brief Estimated minutes until the source is empty, from a least-squares fit over its history
+ * @return Minutes remaining or -1 while there is no discharge trend yet
+ */
+int32_t battery_history_remaining_min(uint8_t source);
@@ -1,14 +1,27 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/sensor.h>
-#include <zephyr/drivers/led.h>
 #include <zephyr/logging/log.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/layer_state_changed.h>
-#include <math.h>
 #include <stdlib.h>
 
+#include "backlight.h"
+#include "brightness.h"
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_DISPLAY_POWER)
+#include "display_power.h"
+#endif
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT)
+#include "ambient_filter.h"
+#endif
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TRIGGER)
+#include "apds9960_als.h"
+#endif
+
 int random0to100()
 {
     return rand() % 101; // 0 to 100
@@ -36,6 +49,14 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #error "DONGLE_SCREEN_BRIGHTNESS_MODIFIER + DONGLE_SCREEN_MAX_BRIGHTNESS can't be smaller than DONGLE_SCREEN_MIN_BRIGHTNESS!"
 #endif
 
+#if CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL && (CONFIG_DONGLE_SCREEN_BRIGHTNESS_UP_KEYCODE == CONFIG_DONGLE_SCREEN_BRIGHTNESS_DOWN_KEYCODE || CONFIG_DONGLE_SCREEN_BRIGHTNESS_UP_KEYCODE == CONFIG_DONGLE_SCREEN_TOGGLE_KEYCODE || CONFIG_DONGLE_SCREEN_BRIGHTNESS_DOWN_KEYCODE == CONFIG_DONGLE_SCREEN_TOGGLE_KEYCODE)
+#error "DONGLE_SCREEN_BRIGHTNESS_UP_KEYCODE, DONGLE_SCREEN_BRIGHTNESS_DOWN_KEYCODE and DONGLE_SCREEN_TOGGLE_KEYCODE must be different!"
+#endif
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM) && CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S >= CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S
+#error "DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S must be shorter than DONGLE_SCREEN_IDLE_TIMEOUT_S!"
+#endif
+
 #if CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT && (CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE > CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE)
 #error "DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE can't be greater than DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE when DONGLE_SCREEN_AMBIENT_LIGHT is activated!"
 #endif
@@ -44,12 +65,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #define BRIGHTNESS_DELAY_MS 2
 #define BRIGHTNESS_FADE_DURATION_MS 500
 #define SCREEN_IDLE_TIMEOUT_MS (CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S * 1000)
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM)
+#define SCREEN_IDLE_DIM_TIMEOUT_MS (CONFIG_DONGLE_SCREEN_IDLE_DIM_TIMEOUT_S * 1000)
+#endif
+#define BRIGHTNESS_WORK_Q_PRIORITY 6
+#define SCREEN_ACTIVITY_HOLDOFF_MS 100 // Activity pushes the idle deadline at most this often
 #define BRIGHTNESS_CHANGE_THRESHOLD 5
 
-static const struct device *pwm_leds_dev = DEVICE_DT_GET_ONE(pwm_leds);
-#define DISP_BL DT_NODE_CHILD_IDX(DT_NODELABEL(disp_bl))
-
-static int64_t last_activity = 0;
 static uint8_t max_brightness = CONFIG_DONGLE_SCREEN_MAX_BRIGHTNESS;
 static uint8_t min_brightness = CONFIG_DONGLE_SCREEN_MIN_BRIGHTNESS;
 static int8_t current_brightness = CONFIG_DONGLE_SCREEN_DEFAULT_BRIGHTNESS;
@@ -58,6 +80,16 @@ static int8_t brightness_modifier = CONFIG_DONGLE_SCREEN_BRIGHTNESS_MODIFIER;
 
 static bool off_through_modifier = false; // Used to track if the screen was turned off through the brightness modifier
 
+// All brightness state above is owned by this work queue. Event listeners and sensor callbacks
+// only post requests to it, so no locking is needed and one stack replaces a thread per task.
+static K_THREAD_STACK_DEFINE(brightness_work_q_stack, CONFIG_DONGLE_SCREEN_BRIGHTNESS_WORK_Q_STACK_SIZE);
+static struct k_work_q brightness_work_q_data;
+
+struct k_work_q *brightness_work_q(void)
+{
+    return &brightness_work_q_data;
+}
+
 /**
  * @brief Structure to hold brightness calculation results
  */
@@ -86,12 +118,6 @@ static uint8_t clamp_brightness(int8_t value)
     return value;
 }
 
-static void apply_brightness(uint8_t value)
-{
-    led_set_brightness(pwm_leds_dev, DISP_BL, value);
-    LOG_INF("Screen brightness set to %d", value);
-}
-
 static int8_t calculate_safe_modifier_change(uint8_t base_brightness, int8_t current_modifier, int8_t desired_change)
 {
     int16_t current_effective = base_brightness + current_modifier;
@@ -199,116 +225,30 @@ static bool should_screen_turn_on(uint8_t base_brightness, int8_t modifier)
     return (base_brightness + modifier) > min_brightness;
 }
 
-// Threaded fade logic
-// Contains starting and target brightness levels to be animated
-struct fade_request_t
-{
-    uint8_t from; // Starting brightness level
-    uint8_t to;   // Target brightness level
-};
-
-#define FADE_QUEUE_SIZE 4
-
-// Message queue used to send fade requests to the fade handler thread.
-// It holds up to 4 fade_request_t elements and ensures brightness updates are handled sequentially.
-K_MSGQ_DEFINE(fade_msgq, sizeof(struct fade_request_t), FADE_QUEUE_SIZE, 4);
-
-// Cubic ease-in-out function to smooth the interpolation curve.
-// Provides a natural "S-curve" animation effect: starts slow, accelerates, then slows again.
-// Helps avoid abrupt changes in perceived brightness.
-static float ease_in_out(float t)
-{
-    if (t < 0.5f)
-        return 4.0f * t * t * t;
-    float f = -2.0f * t + 2.0f;
-    return 1.0f - (f * f * f) / 2.0f;
-}
-
-// Dedicated thread responsible for handling all fade animations.
-// Receives fade requests from the queue and applies brightness changes over time using easing.
-void fade_thread(void)
-{
-    struct fade_request_t req;
-
-    while (1)
-    {
-        // Wait indefinitely for the next fade request to arrive in the queue
-        if (k_msgq_get(&fade_msgq, &req, K_FOREVER) == 0)
-        {
-
-            // Skip animation entirely if brightness difference is too small
-            if (req.from == req.to || abs(req.to - req.from) <= 1)
-            {
-                apply_brightness(req.to);
-                continue;
-            }
-
-            // Calculate brightness difference and use it to determine number of steps
-            int diff = abs(req.to - req.from);
-            int steps = CLAMP(diff * 2, 6, 32); // More steps for smoother fades over large differences
-
-            // Set total animation time: scale with difference but clamp between 500ms and 1000ms
-            int total_duration_ms = CLAMP(diff * 20, 500, 1000); // 20ms per level as baseline
-            int delay_us = (total_duration_ms * 1000) / steps;   // Delay between steps in microseconds
-
-            uint8_t last_applied = 255; // Used to prevent redundant LED updates to save performance
-
-            // Interpolate brightness across 'steps' frames using easing
-            for (int i = 0; i <= steps; i++)
-            {
-                float t = (float)i / steps;                                  // Normalized time in [0, 1]
-                float eased = ease_in_out(t);                                // Eased time for smoother progression
-                float interpolated = req.from + (req.to - req.from) * eased; // Interpolated value
-                uint8_t brightness = (uint8_t)(interpolated + 0.5f);         // Rounded to nearest integer
-
-                // Only send update if brightness actually changed
-                if (brightness != last_applied)
-                {
-                    apply_brightness(brightness);
-                    last_applied = brightness;
-                }
-
-                k_usleep(delay_us); // Sleep before next step to pace the fade
-            }
-
-            // safeguard to ensure the target value is set at the end
-            if (last_applied != req.to)
-            {
-                apply_brightness(req.to);
-            }
-        }
-    }
-}
-
-// Launch the fade thread with 768 bytes of stack, medium priority (6)
-// 512 was too small for logging, math (float, int), small loop, few stack-local variables
-// 768 is just a guess, optimization is possible, probably
-K_THREAD_DEFINE(fade_tid, 768, fade_thread, NULL, NULL, NULL, 6, 0, 0);
-
-// Function to submit a brightness fade request
-// Ensures that only the most recent fade request is applied by purging the queue first for changes in between animations
-static void fade_to_brightness(uint8_t from, uint8_t to)
-{
-    struct fade_request_t req = {.from = from, .to = to};
-    k_msgq_purge(&fade_msgq);                // Clear any pending fades to avoid outdated transitions
-    k_msgq_put(&fade_msgq, &req, K_NO_WAIT); // Submit the new fade request without blocking
-}
-
 void set_screen_brightness(uint8_t value, bool ambient)
 {
     struct brightness_result result = calculate_brightness_with_bounds(value, brightness_modifier, ambient);
 
-    uint8_t current_effective = clamp_brightness(current_brightness + brightness_modifier);
-
-    fade_to_brightness(current_effective, result.effective_brightness);
+    // The backlight fades from the level actually shown, also when a fade is still running
+    backlight_fade_to(result.effective_brightness);
     current_brightness = result.adjusted_brightness;
 }
 
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0 || CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
 // --- Brightness logic ---
 static bool screen_on = true;
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM)
+static bool screen_dimmed = false;
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+static bool screen_proximity_woken = false; // Goes straight off again without typing
+#endif
 // --- Screen on/off ---
 
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+static void proximity_wake_enable(bool enable);
+#endif
+
 static void screen_set_on(bool on)
 {
     if (on && !screen_on)
@@ -321,14 +261,37 @@ static void screen_set_on(bool on)
             LOG_DBG("SCREEN TURN ON: Adjusted brightness to ensure screen can turn on: %d", current_brightness);
         }
 
-        fade_to_brightness(0, clamp_brightness(current_brightness + brightness_modifier));
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_DISPLAY_POWER_OFF)
+        // The panel wakes up on the display work queue while the backlight fades in
+        display_power_on();
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+        proximity_wake_enable(false);
+#endif
+        backlight_fade_to(clamp_brightness(current_brightness + brightness_modifier));
         screen_on = true;
         off_through_modifier = false; // Reset the flag, because the screen is turned on again
         LOG_INF("Screen on (smooth)");
     }
     else if (!on && screen_on)
     {
-        fade_to_brightness(clamp_brightness(current_brightness + brightness_modifier), 0);
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM)
+        if (screen_dimmed)
+        {
+            // Full refresh rate is restored before the panel sleeps, so waking doesn't need it
+            display_power_set_dimmed(false);
+            screen_dimmed = false;
+        }
+#endif
+        uint32_t fade_ms = backlight_fade_to(0);
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_DISPLAY_POWER_OFF)
+        display_power_off(fade_ms);
+#else
+        ARG_UNUSED(fade_ms);
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+        proximity_wake_enable(true);
+#endif
         screen_on = false;
         LOG_INF("Screen off (smooth)");
     }
@@ -340,63 +303,79 @@ static void screen_set_on(bool on)
 
 #endif
 
-// --- Idle thread ---
+// --- Idle timeout ---
 
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0
 
-void screen_idle_thread(void)
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM)
+
+static void screen_dim(void)
 {
-    while (1)
-    {
-        // Thread should run even if the screen is off, but only if the screen is off through the modifier
-        if (screen_on || (!screen_on && off_through_modifier))
-        {
-            int64_t now = k_uptime_get();
-            int64_t elapsed = now - last_activity;
-            int64_t remaining = SCREEN_IDLE_TIMEOUT_MS - elapsed;
+    uint8_t level = MIN(clamp_brightness(current_brightness + brightness_modifier), CONFIG_DONGLE_SCREEN_IDLE_DIM_BRIGHTNESS);
 
-            if (remaining <= 0)
-            {
-                screen_set_on(false);
-                off_through_modifier = false; // Reset the flag, because the screen is turned off
-                // After turning off, sleep until next activity (key event will wake screen)
-                k_sleep(K_FOREVER);
-            }
-            else
-            {
-                // Sleep exactly as long as needed until timeout or next key event
-                k_sleep(K_MSEC(remaining));
-            }
-        }
-        else
-        {
-            // If Screen is off, sleep forever (will be interrupted by key event)
-            k_sleep(K_FOREVER);
-        }
-    }
+    backlight_fade_to(level);
+    display_power_set_dimmed(true);
+    screen_dimmed = true;
+    LOG_INF("Screen dimmed to %d", level);
 }
 
-K_THREAD_DEFINE(screen_idle_tid, 512, screen_idle_thread, NULL, NULL, NULL, 7, 0, 0);
-
-void brightness_wake_screen_on_reconnect(void)
+static void screen_undim(void)
 {
-    if (!screen_on)
+    if (!screen_dimmed)
     {
-        LOG_INF("Peripheral reconnected, waking screen");
+        return;
+    }
 
-        screen_set_on(true);
+    display_power_set_dimmed(false);
+    backlight_fade_to(clamp_brightness(current_brightness + brightness_modifier));
+    screen_dimmed = false;
+    LOG_INF("Screen undimmed");
+}
+
+#endif
 
-        // Reset idle timer
-        last_activity = k_uptime_get();
+static void screen_idle_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(screen_idle_work, screen_idle_work_handler);
 
-        k_wakeup(screen_idle_tid);
+static void screen_idle_work_handler(struct k_work *work)
+{
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM)
+    // First stage: dim and render less often, the screen turns off at the full idle timeout
+    bool dim = screen_on && !screen_dimmed;
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+    dim = dim && !screen_proximity_woken;
+#endif
+    if (dim)
+    {
+        screen_dim();
+        k_work_reschedule_for_queue(&brightness_work_q_data, &screen_idle_work,
+                                    K_MSEC(SCREEN_IDLE_TIMEOUT_MS - SCREEN_IDLE_DIM_TIMEOUT_MS));
+        return;
     }
-    else
+#endif
+
+    // Also runs when the screen is off through the modifier, so the next activity turns it on again
+    if (screen_on || off_through_modifier)
     {
-        LOG_DBG("Peripheral reconnected but screen already on");
+        screen_set_on(false);
+        off_through_modifier = false; // Reset the flag, because the screen is turned off
     }
 }
 
+// Every activity pushes the timeout back, so it only fires once the dongle is really idle
+static void screen_idle_restart(void)
+{
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+    screen_proximity_woken = false;
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM)
+    screen_undim();
+    k_work_reschedule_for_queue(&brightness_work_q_data, &screen_idle_work, K_MSEC(SCREEN_IDLE_DIM_TIMEOUT_MS));
+#else
+    k_work_reschedule_for_queue(&brightness_work_q_data, &screen_idle_work, K_MSEC(SCREEN_IDLE_TIMEOUT_MS));
+#endif
+}
+
 #endif
 
 // --- Brightness control via keyboard ---
@@ -458,62 +437,201 @@ static void decrease_brightness(void)
 
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0 || CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
 
-// --- Key event listener ---
+// --- Requests from event listeners ---
 
-static int key_listener(const zmk_event_t *eh)
+enum brightness_request
 {
-    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
-    if (ev && ev->state)
-    { // Only on key down
-        LOG_DBG("Key pressed: keycode=%d", ev->keycode);
+    BRIGHTNESS_REQUEST_WAKE,
+    BRIGHTNESS_REQUEST_PROXIMITY,
+};
+
+static atomic_t brightness_requests;
+static atomic_t brightness_key_steps;     // Pending brightness key presses, up +1 and down -1
+static atomic_t brightness_toggle_count; // Pending screen toggle key presses
+
+static atomic_t screen_activity_count;   // Bumped by every event, the only per-key cost
+static atomic_t screen_activity_pending; // Set while a holdoff window is running
+static atomic_val_t screen_activity_seen;
+
+static void screen_activity(void)
+{
+#if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0
+    screen_idle_restart();
+    if (!screen_on && !off_through_modifier)
+    {
+        screen_set_on(true);
+    }
+#else
+    // Without idle timeout: just turn on screen
+    if (!screen_on)
+    {
+        screen_set_on(true);
+    }
+#endif
+}
+
+#if CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
+static void screen_toggle(void)
+{
+    if (screen_on)
+    {
+        off_through_modifier = true; // Track that the screen was turned off through the toggle key
+        screen_set_on(false);
+    }
+    else
+    {
+        screen_set_on(true);
+    }
+}
+#endif
 
+static void brightness_request_work_handler(struct k_work *work)
+{
 #if CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
-        if (ev->keycode == CONFIG_DONGLE_SCREEN_BRIGHTNESS_UP_KEYCODE)
+    // Key presses that arrived while the queue was busy are applied in one go
+    atomic_val_t steps = atomic_clear(&brightness_key_steps);
+    if (steps != 0)
+    {
+        LOG_DBG("Brightness keys: %d step(s)", (int)steps);
+    }
+    for (; steps != 0; steps += steps > 0 ? -1 : 1)
+    {
+        if (steps > 0)
         {
-            LOG_INF("Brightness UP key recognized!");
             increase_brightness();
-            return 0;
         }
-        else if (ev->keycode == CONFIG_DONGLE_SCREEN_BRIGHTNESS_DOWN_KEYCODE)
+        else
         {
-            LOG_INF("Brightness DOWN key recognized!");
             decrease_brightness();
-            return 0;
-        }
-        else if (ev->keycode == CONFIG_DONGLE_SCREEN_TOGGLE_KEYCODE)
-        {
-            LOG_INF("Toggle screen key recognized!");
-            // Toggle screen on/off
-            if (screen_on)
-            {
-                off_through_modifier = true; // Track that the screen was turned off through the toggle key
-                screen_set_on(false);
-            }
-            else
-            {
-                screen_set_on(true);
-            }
-            return 0;
         }
+    }
 
-#endif
+    // Pairs of toggles cancel out
+    if (atomic_clear(&brightness_toggle_count) & 1)
+    {
+        LOG_INF("Toggle screen key recognized!");
+        screen_toggle();
     }
+#endif
 
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0
-    last_activity = k_uptime_get();
-    if (!screen_on && !off_through_modifier)
+    if (atomic_test_and_clear_bit(&brightness_requests, BRIGHTNESS_REQUEST_WAKE))
     {
-        screen_set_on(true);
-        k_wakeup(screen_idle_tid);
+        if (!screen_on)
+        {
+            LOG_INF("Peripheral reconnected, waking screen");
+            screen_set_on(true);
+            screen_idle_restart();
+        }
+        else
+        {
+            LOG_DBG("Peripheral reconnected but screen already on");
+        }
     }
-#else
-    // Without idle thread: just turn on screen
-    if (!screen_on)
+#endif
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+    // A hand approaching the keyboard wakes the screen before the first key arrives. Without
+    // typing it goes off again after the short proximity timeout.
+    if (atomic_test_and_clear_bit(&brightness_requests, BRIGHTNESS_REQUEST_PROXIMITY) &&
+        !screen_on && !off_through_modifier)
     {
+        LOG_INF("Proximity detected, waking screen");
         screen_set_on(true);
+        screen_proximity_woken = true;
+        k_work_reschedule_for_queue(&brightness_work_q_data, &screen_idle_work,
+                                    K_MSEC(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE_TIMEOUT_MS));
     }
 #endif
-    return 0;
+}
+
+static K_WORK_DEFINE(brightness_request_work, brightness_request_work_handler);
+
+// Handles the first activity right away and then runs once per holdoff window while the activity
+// goes on, so the idle deadline is pushed at most every SCREEN_ACTIVITY_HOLDOFF_MS and the
+// listener never has to read the clock.
+static void screen_activity_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(screen_activity_work, screen_activity_work_handler);
+
+static void screen_activity_work_handler(struct k_work *work)
+{
+    atomic_val_t count = atomic_get(&screen_activity_count);
+
+    if (count == screen_activity_seen)
+    {
+        // No activity during the last window, stop until the listener starts a new one
+        atomic_clear(&screen_activity_pending);
+
+        // An event between the read and the clear didn't start a window, take it from here
+        count = atomic_get(&screen_activity_count);
+        if (count == screen_activity_seen || !atomic_cas(&screen_activity_pending, 0, 1))
+        {
+            return;
+        }
+    }
+
+    screen_activity_seen = count;
+    screen_activity();
+    k_work_schedule_for_queue(&brightness_work_q_data, &screen_activity_work, K_MSEC(SCREEN_ACTIVITY_HOLDOFF_MS));
+}
+
+static void brightness_request_submit(void)
+{
+    k_work_submit_to_queue(&brightness_work_q_data, &brightness_request_work);
+}
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+static void proximity_triggered(void)
+{
+    atomic_set_bit(&brightness_requests, BRIGHTNESS_REQUEST_PROXIMITY);
+    brightness_request_submit();
+}
+#endif
+
+#if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0
+void brightness_wake_screen_on_reconnect(void)
+{
+    atomic_set_bit(&brightness_requests, BRIGHTNESS_REQUEST_WAKE);
+    brightness_request_submit();
+}
+#endif
+
+// --- Key event listener ---
+
+// Runs synchronously in the input path for every key and layer change, so it only classifies the
+// event and leaves all brightness work, including logging, to the brightness work queue
+static int key_listener(const zmk_event_t *eh)
+{
+#if CONFIG_DONGLE_SCREEN_BRIGHTNESS_KEYBOARD_CONTROL
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    if (ev && ev->state)
+    { // Only on key down
+        switch (ev->keycode)
+        {
+        case CONFIG_DONGLE_SCREEN_BRIGHTNESS_UP_KEYCODE:
+            atomic_inc(&brightness_key_steps);
+            brightness_request_submit();
+            return ZMK_EV_EVENT_BUBBLE;
+        case CONFIG_DONGLE_SCREEN_BRIGHTNESS_DOWN_KEYCODE:
+            atomic_dec(&brightness_key_steps);
+            brightness_request_submit();
+            return ZMK_EV_EVENT_BUBBLE;
+        case CONFIG_DONGLE_SCREEN_TOGGLE_KEYCODE:
+            atomic_inc(&brightness_toggle_count);
+            brightness_request_submit();
+            return ZMK_EV_EVENT_BUBBLE;
+        default:
+            break;
+        }
+    }
+#endif
+
+    atomic_inc(&screen_activity_count);
+    if (atomic_cas(&screen_activity_pending, 0, 1))
+    {
+        k_work_reschedule_for_queue(&brightness_work_q_data, &screen_activity_work, K_NO_WAIT);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
 }
 
 ZMK_LISTENER(screen_idle, key_listener);
@@ -535,88 +653,203 @@ static uint8_t ambient_to_brightness(int32_t sensor_value)
 {
     if (sensor_value < min_sensor)
     {
-        LOG_INF("Ambient sensor reading (%d) below DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE: (%d) Will set the sensor reading to the minimum configured.", sensor_value, CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE);
+        LOG_DBG("Ambient sensor reading (%d) below DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE: (%d) Will set the sensor reading to the minimum configured.", sensor_value, CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MIN_RAW_VALUE);
         sensor_value = min_sensor;
     }
 
     if (sensor_value > max_sensor)
     {
-        LOG_INF("Ambient sensor reading (%d) above DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE: (%d) Will set the sensor reading to the maximum configured.", sensor_value, CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE);
+        LOG_DBG("Ambient sensor reading (%d) above DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE: (%d) Will set the sensor reading to the maximum configured.", sensor_value, CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_MAX_RAW_VALUE);
         sensor_value = max_sensor;
     }
 
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_LOG_CURVE)
+    // Perceived brightness follows the logarithm of the illuminance, so map in the log2 domain
+    uint32_t log_min = ambient_log2_q8(min_sensor);
+    uint32_t log_range = ambient_log2_q8(max_sensor) - log_min;
+    uint8_t brightness = min_brightness +
+                         ((ambient_log2_q8(sensor_value) - log_min) * (max_brightness - min_brightness)) /
+                             MAX(log_range, 1);
+#else
     uint8_t brightness = min_brightness +
                          ((sensor_value - min_sensor) * (max_brightness - min_brightness)) /
                              (max_sensor - min_sensor);
+#endif
     return clamp_brightness(brightness);
 }
 
-static void ambient_light_thread(void)
+#ifdef CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
+// Random test readings change less often, so the fades can be followed
+#define AMBIENT_LIGHT_INTERVAL_MS (10000 + CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_EVALUATION_INTERVAL_MS)
+#else
+#define AMBIENT_LIGHT_INTERVAL_MS CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_EVALUATION_INTERVAL_MS
+#endif
+
+static void ambient_light_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(ambient_light_work, ambient_light_work_handler);
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TRIGGER)
+
+// Smallest threshold window in raw counts, so very dark readings don't trigger on sensor noise
+#define AMBIENT_TRIGGER_MIN_WINDOW 2
+
+static bool ambient_trigger_initialized = false;
+static bool ambient_trigger_active = false;
+
+static void ambient_light_triggered(void)
 {
-    struct sensor_value val;
-    uint8_t last_brightness = 0xFF; // Invalid initial value to force first update
+    k_work_reschedule_for_queue(&brightness_work_q_data, &ambient_light_work, K_NO_WAIT);
+}
 
-    while (1)
+static void ambient_light_trigger_init(void)
+{
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+    int trigger_rc = apds9960_als_trigger_init(ambient_sensor, ambient_light_triggered, proximity_triggered);
+#else
+    int trigger_rc = apds9960_als_trigger_init(ambient_sensor, ambient_light_triggered, NULL);
+#endif
+    if (trigger_rc < 0)
     {
+        LOG_WRN("Ambient light trigger unavailable (%d), polling instead", trigger_rc);
+    }
+    ambient_trigger_active = trigger_rc == 0;
+    ambient_trigger_initialized = true;
+}
 
-#ifndef CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE)
+// The proximity engine only runs while the screen is off, it isn't needed otherwise
+static void proximity_wake_enable(bool enable)
+{
+    if (!ambient_trigger_active)
+    {
+        return;
+    }
 
-        if (!device_is_ready(ambient_sensor))
-        {
-            LOG_ERR("Ambient light sensor not ready!");
-            k_sleep(K_SECONDS(5));
-            continue;
-        }
-        int rc = sensor_sample_fetch(ambient_sensor);
-        if (rc == 0)
-        {
-            rc = sensor_channel_get(ambient_sensor, SENSOR_CHAN_LIGHT, &val);
-            if (rc == 0)
-            {
+    int rc = enable ? apds9960_prox_arm(ambient_sensor, CONFIG_DONGLE_SCREEN_PROXIMITY_WAKE_THRESHOLD)
+                    : apds9960_prox_disarm(ambient_sensor);
+    if (rc < 0)
+    {
+        LOG_WRN("Couldn't %s the proximity wake (%d)", enable ? "arm" : "disarm", rc);
+    }
+}
+#endif
+
+// Arms the ALS thresholds around the last evaluated reading, the next sample is only taken when
+// the sensor interrupts. Outside the configured raw range the brightness can't change any
+// further, so that side of the window stays disabled.
+static bool ambient_light_wait_for_change(int32_t reading)
+{
+    if (!ambient_trigger_active)
+    {
+        return false;
+    }
+
+    int32_t window = MAX(reading * CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TRIGGER_WINDOW_PERCENT / 100,
+                         AMBIENT_TRIGGER_MIN_WINDOW);
+    uint16_t low = reading <= min_sensor ? 0 : CLAMP(reading - window, 0, UINT16_MAX);
+    uint16_t high = reading >= max_sensor ? UINT16_MAX : CLAMP(reading + window, 0, UINT16_MAX);
+
+    if (apds9960_als_arm(ambient_sensor, low, high) < 0)
+    {
+        LOG_WRN("Couldn't arm the ambient light interrupt, polling instead");
+        return false;
+    }
+
+    LOG_DBG("Ambient light: waiting for a reading outside %d..%d", low, high);
+    return true;
+}
+
+#endif // CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TRIGGER
+
+static void ambient_light_apply(int32_t raw)
+{
+    int32_t filtered = ambient_filter_sample(raw);
+    uint8_t new_brightness;
+
+    // Only changes that last for the dwell time and exceed the threshold start a fade
+    if (!ambient_hysteresis_update(ambient_to_brightness(filtered), BRIGHTNESS_CHANGE_THRESHOLD,
+                                   k_uptime_get(), &new_brightness))
+    {
+        return;
+    }
+
+    struct brightness_result result = calculate_brightness_with_bounds(new_brightness, brightness_modifier, true);
+
+    LOG_DBG("Ambient light: %d (raw), %d (filtered) -> brightness %d, effective (incl. modifier) %d",
+            raw, filtered, result.adjusted_brightness, result.effective_brightness);
+
+    if (result.hit_min_limit)
+    {
+        LOG_DBG("Ambient brightness at minimum limit");
+    }
+    if (result.hit_max_limit)
+    {
+        LOG_DBG("Ambient brightness at maximum limit");
+    }
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM)
+    // While dimmed only the level to return to is updated
+    bool apply = screen_on && !screen_dimmed;
 #else
-        k_sleep(K_SECONDS(10));
-        val.val1 = random0to100();
-
-#endif
-                uint8_t new_brightness = ambient_to_brightness(val.val1);
-
-                if (abs(new_brightness - last_brightness) > BRIGHTNESS_CHANGE_THRESHOLD)
-                {
-                    struct brightness_result result = calculate_brightness_with_bounds(new_brightness, brightness_modifier, true);
-
-                    LOG_DBG("Ambient light: %d (raw) -> brightness %d, effective (incl. modifier) %d",
-                            val.val1, result.adjusted_brightness, result.effective_brightness);
-
-                    if (result.hit_min_limit)
-                    {
-                        LOG_DBG("Ambient brightness at minimum limit");
-                    }
-                    if (result.hit_max_limit)
-                    {
-                        LOG_DBG("Ambient brightness at maximum limit");
-                    }
-
-                    if (screen_on)
-                    {
-                        set_screen_brightness(new_brightness, true);
-                    }
-                    else
-                    {
-                        // If the screen is off, just set the brightness variable
-                        // to have the current ambient brightness when the screen is turned on again
-                        current_brightness = result.adjusted_brightness;
-                    }
-                    last_brightness = new_brightness;
-                }
-#ifndef CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
-            }
-        }
-#endif                                                                              // CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
-        k_sleep(K_MSEC(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_EVALUATION_INTERVAL_MS)); // Adjust interval as needed
+    bool apply = screen_on;
+#endif
+    if (apply)
+    {
+        set_screen_brightness(new_brightness, true);
+    }
+    else
+    {
+        // If the screen is off, just set the brightness variable
+        // to have the current ambient brightness when the screen is turned on again
+        current_brightness = result.adjusted_brightness;
     }
 }
 
-K_THREAD_DEFINE(ambient_light_tid, 512, ambient_light_thread, NULL, NULL, NULL, 7, 0, 0);
+// One sample per run, rescheduled after the evaluation interval or by the sensor interrupt
+static void ambient_light_work_handler(struct k_work *work)
+{
+    struct sensor_value val;
+
+#ifndef CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TEST
+    if (!device_is_ready(ambient_sensor))
+    {
+        LOG_ERR("Ambient light sensor not ready!");
+        k_work_schedule_for_queue(&brightness_work_q_data, &ambient_light_work, K_SECONDS(5));
+        return;
+    }
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TRIGGER)
+    if (!ambient_trigger_initialized)
+    {
+        ambient_light_trigger_init();
+    }
+#endif
+
+    int rc = sensor_sample_fetch(ambient_sensor);
+    if (rc == 0)
+    {
+        rc = sensor_channel_get(ambient_sensor, SENSOR_CHAN_LIGHT, &val);
+    }
+#else
+    int rc = 0;
+    val.val1 = random0to100();
+#endif
+
+    if (rc == 0)
+    {
+        ambient_light_apply(val.val1);
+    }
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT_TRIGGER)
+    // No I2C traffic and no wakeups until the light actually changes. While a change is
+    // waiting for its dwell time or the filters converge, keep sampling at the interval.
+    if (rc == 0 && !ambient_filter_settling() && ambient_light_wait_for_change(val.val1))
+    {
+        return;
+    }
+#endif
+    k_work_schedule_for_queue(&brightness_work_q_data, &ambient_light_work, K_MSEC(AMBIENT_LIGHT_INTERVAL_MS));
+}
 
 #endif // CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT
 
@@ -624,15 +857,20 @@ K_THREAD_DEFINE(ambient_light_tid, 512, ambient_light_thread, NULL, NULL, NULL,
 
 static int init_fixed_brightness(void)
 {
+    k_work_queue_start(&brightness_work_q_data, brightness_work_q_stack,
+                       K_THREAD_STACK_SIZEOF(brightness_work_q_stack), BRIGHTNESS_WORK_Q_PRIORITY,
+                       &(struct k_work_queue_config){.name = "brightness"});
+
     set_screen_brightness(current_brightness, false);
-    last_activity = k_uptime_get();
 #if CONFIG_DONGLE_SCREEN_IDLE_TIMEOUT_S > 0
-    // Wake up the idle thread at boot
-    k_wakeup(screen_idle_tid);
+    screen_idle_restart();
 #else
     LOG_INF("Screen idle timeout disabled");
+#endif
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_AMBIENT_LIGHT)
+    k_work_schedule_for_queue(&brightness_work_q_data, &ambient_light_work, K_NO_WAIT);
 #endif
     return 0;
 }
 
-SYS_INIT(init_fixed_brightness, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
\ No newline at end of file
+SYS_INIT(init_fixed_brightness, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -6,8 +6,17 @@
 
 #pragma once
 
+#include <zephyr/kernel.h>
+
+/**
+ * @brief Work queue that owns the backlight state
+ * The idle timeout, the keyboard brightness control, the ambient light sampling and the
+ * software fade steps all run here, so they never race each other
+ */
+struct k_work_q *brightness_work_q(void);
+
 /**
  * @brief Wake the screen when a peripheral reconnects
  * Called by battery widget when it detects a peripheral reconnection
  */
-void brightness_wake_screen_on_reconnect(void);
\ No newline at end of file
+void brightness_wake_screen_on_reconnect(void);
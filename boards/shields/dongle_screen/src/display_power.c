@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/logging/log.h>
+#include <zmk/display.h>
+#include <lvgl.h>
+
+#include <dongle_screen/st7789v.h>
+
+#include "display_power.h"
+#include "telemetry.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+
+static const struct device *display __maybe_unused = DEVICE_DT_GET(DISPLAY_NODE);
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_DISPLAY_POWER_OFF)
+
+// Suspending the SPI bus switches its pins to the sleep pinctrl state (spi3_sleep)
+#if DT_ON_BUS(DISPLAY_NODE, spi)
+static const struct device *display_bus = DEVICE_DT_GET(DT_BUS(DISPLAY_NODE));
+#else
+static const struct device *display_bus = NULL;
+#endif
+
+// Only touched from the display work queue, which also runs LVGL and the flushes
+static bool display_powered = true;
+
+static void display_power_action(const struct device *dev, enum pm_device_action action)
+{
+    if (dev == NULL)
+    {
+        return;
+    }
+
+    int rc = pm_device_action_run(dev, action);
+    // Devices without power management (e.g. the memory display) simply stay on
+    if (rc < 0 && rc != -EALREADY && rc != -ENOSYS)
+    {
+        LOG_WRN("Power action %d on %s failed (%d)", action, dev->name, rc);
+    }
+}
+
+static void display_refresh_set_paused(bool paused)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+
+    if (disp == NULL || disp->refr_timer == NULL)
+    {
+        return;
+    }
+
+    if (paused)
+    {
+        lv_timer_pause(disp->refr_timer);
+    }
+    else
+    {
+        lv_timer_resume(disp->refr_timer);
+    }
+}
+
+static void display_power_off_work_handler(struct k_work *work)
+{
+    if (!display_powered)
+    {
+        return;
+    }
+
+    // Widgets keep invalidating while paused, the first refresh after wake catches up
+    display_refresh_set_paused(true);
+    display_power_action(display, PM_DEVICE_ACTION_SUSPEND);
+    display_power_action(display_bus, PM_DEVICE_ACTION_SUSPEND);
+    display_powered = false;
+    telemetry_panel(false);
+    LOG_DBG("Display powered down");
+}
+
+static void display_power_on_work_handler(struct k_work *work)
+{
+    if (display_powered)
+    {
+        return;
+    }
+
+    display_power_action(display_bus, PM_DEVICE_ACTION_RESUME);
+    display_power_action(display, PM_DEVICE_ACTION_RESUME);
+    display_refresh_set_paused(false);
+    display_powered = true;
+    telemetry_panel(true);
+    LOG_DBG("Display powered up");
+}
+
+static K_WORK_DELAYABLE_DEFINE(display_power_off_work, display_power_off_work_handler);
+static K_WORK_DEFINE(display_power_on_work, display_power_on_work_handler);
+
+void display_power_off(uint32_t delay_ms)
+{
+    k_work_reschedule_for_queue(zmk_display_work_q(), &display_power_off_work, K_MSEC(delay_ms));
+}
+
+void display_power_on(void)
+{
+    // A power down that is still waiting for the fade-out is simply dropped
+    k_work_cancel_delayable(&display_power_off_work);
+    k_work_submit_to_queue(zmk_display_work_q(), &display_power_on_work);
+}
+
+#endif // CONFIG_DONGLE_SCREEN_DISPLAY_POWER_OFF
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_IDLE_DIM)
+
+static atomic_t display_dim_requested;
+static bool display_dimmed = false;
+
+static void display_dim_work_handler(struct k_work *work)
+{
+    bool dimmed = atomic_get(&display_dim_requested);
+
+    if (dimmed == display_dimmed)
+    {
+        return;
+    }
+
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp != NULL && disp->refr_timer != NULL)
+    {
+        lv_timer_set_period(disp->refr_timer, dimmed ? CONFIG_DONGLE_SCREEN_IDLE_DIM_REFRESH_PERIOD_MS
+                                                     : CONFIG_LV_DISP_DEF_REFR_PERIOD);
+    }
+
+#if DT_NODE_HAS_COMPAT(DISPLAY_NODE, sitronix_st7789v)
+    // Fewer panel refreshes per second lower the panel's own current, the content is static
+    st7789v_set_frame_rate(display, dimmed ? CONFIG_DONGLE_SCREEN_IDLE_DIM_FRCTRL2 : ST7789V_FRCTRL2_60HZ);
+#endif
+
+    display_dimmed = dimmed;
+    LOG_DBG("Display %s", dimmed ? "dimmed" : "undimmed");
+}
+
+static K_WORK_DEFINE(display_dim_work, display_dim_work_handler);
+
+void display_power_set_dimmed(bool dimmed)
+{
+    atomic_set(&display_dim_requested, dimmed);
+    k_work_submit_to_queue(zmk_display_work_q(), &display_dim_work);
+}
+
+#endif // CONFIG_DONGLE_SCREEN_IDLE_DIM
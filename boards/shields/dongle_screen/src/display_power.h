@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Power the display down once the backlight fade-out finished
+ * Pauses LVGL rendering, puts the panel into sleep mode and suspends the SPI bus
+ * @param delay_ms Duration of the running fade-out
+ */
+void display_power_off(uint32_t delay_ms);
+
+/**
+ * @brief Resume the SPI bus, wake the panel and restart rendering
+ * Runs on the display work queue, so it overlaps with the backlight fade-in
+ */
+void display_power_on(void);
+
+/**
+ * @brief Slow down LVGL rendering and the panel frame rate while the screen is dimmed
+ */
+void display_power_set_dimmed(bool dimmed);
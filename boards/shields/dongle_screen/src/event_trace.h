@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Binary event trace format
+ *
+ * A trace starts with an 8 byte header ("DSTR", version, 3 reserved bytes),
+ * followed by fixed-size 6 byte records, all little-endian:
+ *
+ *   uint16_t dt_ms;  // time since the previous record, saturated
+ *   uint8_t  type;   // enum event_trace_type
+ *   uint8_t  arg;    // type specific
+ *   uint16_t value;  // type specific
+ *
+ * Gaps longer than UINT16_MAX ms are encoded with EVENT_TRACE_DELAY records.
+ */
+
+#define EVENT_TRACE_MAGIC "DSTR"
+#define EVENT_TRACE_VERSION 1
+#define EVENT_TRACE_HEADER_SIZE 8
+#define EVENT_TRACE_RECORD_SIZE 6
+
+enum event_trace_type
+{
+    EVENT_TRACE_DELAY = 0,  // no event, only dt_ms
+    EVENT_TRACE_KEYCODE,    // arg: bit 0 pressed, bits 1-7 usage page; value: keycode
+    EVENT_TRACE_LAYER,      // arg: layer; value: active
+    EVENT_TRACE_WPM,        // value: wpm
+    EVENT_TRACE_MODIFIERS,  // arg: HID modifier byte after the preceding keycode
+    EVENT_TRACE_BATTERY,    // arg: peripheral source or EVENT_TRACE_BATTERY_CENTRAL; value: level
+    EVENT_TRACE_ENDPOINT,   // arg: transport; value: BLE profile index
+    EVENT_TRACE_CAPS_WORD,  // arg: active
+    EVENT_TRACE_TYPE_COUNT,
+};
+
+#define EVENT_TRACE_BATTERY_CENTRAL 0xFF
+
+struct event_trace_record
+{
+    uint16_t dt_ms;
+    uint8_t type;
+    uint8_t arg;
+    uint16_t value;
+};
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/wpm_state_changed.h>
+#include <zmk/events/battery_state_changed.h>
+#include <zmk/events/endpoint_changed.h>
+#include <zmk/events/caps_word_state_changed.h>
+#include <dt-bindings/zmk/hid_usage_pages.h>
+
+#include "event_trace.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define MODIFIER_KEYCODE_FIRST 0xE0
+#define MODIFIER_KEYCODE_LAST 0xE7
+
+static uint8_t trace_buffer[CONFIG_DONGLE_SCREEN_EVENT_TRACE_BUFFER_SIZE];
+static size_t trace_len;
+static uint32_t trace_dropped;
+static int64_t trace_last_ms;
+static uint8_t trace_modifiers;
+static bool trace_running = IS_ENABLED(CONFIG_DONGLE_SCREEN_EVENT_TRACE_AUTOSTART);
+static struct k_spinlock trace_lock;
+
+static void trace_reset(void)
+{
+    memcpy(trace_buffer, EVENT_TRACE_MAGIC, 4);
+    trace_buffer[4] = EVENT_TRACE_VERSION;
+    memset(&trace_buffer[5], 0, EVENT_TRACE_HEADER_SIZE - 5);
+    trace_len = EVENT_TRACE_HEADER_SIZE;
+    trace_dropped = 0;
+    trace_last_ms = k_uptime_get();
+    // Replay starts from an empty HID report, so the tracked modifiers do as well
+    trace_modifiers = 0;
+}
+
+static bool trace_put(uint16_t dt_ms, enum event_trace_type type, uint8_t arg, uint16_t value)
+{
+    if (trace_len + EVENT_TRACE_RECORD_SIZE > sizeof(trace_buffer))
+    {
+        trace_dropped++;
+        return false;
+    }
+
+    uint8_t *rec = &trace_buffer[trace_len];
+    sys_put_le16(dt_ms, rec);
+    rec[2] = type;
+    rec[3] = arg;
+    sys_put_le16(value, &rec[4]);
+    trace_len += EVENT_TRACE_RECORD_SIZE;
+    return true;
+}
+
+// Called with trace_lock held
+static void trace_append_locked(enum event_trace_type type, uint8_t arg, uint16_t value)
+{
+    if (trace_running)
+    {
+        int64_t now = k_uptime_get();
+        int64_t dt = now - trace_last_ms;
+
+        // Long pauses are split into delay records so dt_ms never wraps
+        while (dt > UINT16_MAX && trace_put(UINT16_MAX, EVENT_TRACE_DELAY, 0, 0))
+        {
+            dt -= UINT16_MAX;
+        }
+        if (trace_put((uint16_t)dt, type, arg, value))
+        {
+            trace_last_ms = now;
+        }
+    }
+}
+
+static void trace_append(enum event_trace_type type, uint8_t arg, uint16_t value)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+    trace_append_locked(type, arg, value);
+    k_spin_unlock(&trace_lock, key);
+}
+
+// Tracks the modifier byte from the modifier keycodes themselves, since this listener may run
+// before the HID report is updated
+static void trace_keycode(const struct zmk_keycode_state_changed *ev)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+    trace_append_locked(EVENT_TRACE_KEYCODE, (ev->usage_page << 1) | (ev->state ? 1 : 0),
+                        ev->keycode);
+
+    if (ev->usage_page == HID_USAGE_KEY && ev->keycode >= MODIFIER_KEYCODE_FIRST &&
+        ev->keycode <= MODIFIER_KEYCODE_LAST)
+    {
+        uint8_t bit = BIT(ev->keycode - MODIFIER_KEYCODE_FIRST);
+        uint8_t modifiers = ev->state ? (trace_modifiers | bit) : (trace_modifiers & ~bit);
+
+        if (modifiers != trace_modifiers)
+        {
+            trace_modifiers = modifiers;
+            trace_append_locked(EVENT_TRACE_MODIFIERS, modifiers, 0);
+        }
+    }
+
+    k_spin_unlock(&trace_lock, key);
+}
+
+static int event_trace_listener(const zmk_event_t *eh)
+{
+    const struct zmk_keycode_state_changed *keycode = as_zmk_keycode_state_changed(eh);
+    if (keycode)
+    {
+        trace_keycode(keycode);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_layer_state_changed *layer = as_zmk_layer_state_changed(eh);
+    if (layer)
+    {
+        trace_append(EVENT_TRACE_LAYER, layer->layer, layer->state);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_wpm_state_changed *wpm = as_zmk_wpm_state_changed(eh);
+    if (wpm)
+    {
+        trace_append(EVENT_TRACE_WPM, 0, wpm->state);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_peripheral_battery_state_changed *peripheral_battery = as_zmk_peripheral_battery_state_changed(eh);
+    if (peripheral_battery)
+    {
+        trace_append(EVENT_TRACE_BATTERY, peripheral_battery->source, peripheral_battery->state_of_charge);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_battery_state_changed *battery = as_zmk_battery_state_changed(eh);
+    if (battery)
+    {
+        trace_append(EVENT_TRACE_BATTERY, EVENT_TRACE_BATTERY_CENTRAL, battery->state_of_charge);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_endpoint_changed *endpoint = as_zmk_endpoint_changed(eh);
+    if (endpoint)
+    {
+        trace_append(EVENT_TRACE_ENDPOINT, endpoint->endpoint.transport, endpoint->endpoint.ble.profile_index);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_caps_word_state_changed *caps_word = as_zmk_caps_word_state_changed(eh);
+    if (caps_word)
+    {
+        trace_append(EVENT_TRACE_CAPS_WORD, caps_word->active, 0);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(event_trace, event_trace_listener);
+ZMK_SUBSCRIPTION(event_trace, zmk_keycode_state_changed);
+ZMK_SUBSCRIPTION(event_trace, zmk_layer_state_changed);
+ZMK_SUBSCRIPTION(event_trace, zmk_wpm_state_changed);
+ZMK_SUBSCRIPTION(event_trace, zmk_peripheral_battery_state_changed);
+ZMK_SUBSCRIPTION(event_trace, zmk_battery_state_changed);
+ZMK_SUBSCRIPTION(event_trace, zmk_endpoint_changed);
+ZMK_SUBSCRIPTION(event_trace, zmk_caps_word_state_changed);
+
+static int event_trace_init(void)
+{
+    trace_reset();
+    return 0;
+}
+
+SYS_INIT(event_trace_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if IS_ENABLED(CONFIG_SHELL)
+
+static int cmd_trace_start(const struct shell *sh, size_t argc, char **argv)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+    trace_reset();
+    trace_running = true;
+    k_spin_unlock(&trace_lock, key);
+
+    shell_print(sh, "Recording (%zu bytes buffer)", sizeof(trace_buffer));
+    return 0;
+}
+
+static int cmd_trace_stop(const struct shell *sh, size_t argc, char **argv)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+    trace_running = false;
+    k_spin_unlock(&trace_lock, key);
+
+    shell_print(sh, "Stopped: %zu records, %u dropped",
+                (trace_len - EVENT_TRACE_HEADER_SIZE) / EVENT_TRACE_RECORD_SIZE, trace_dropped);
+    return 0;
+}
+
+// Prints "trace: <hex>" lines, scripts/trace_from_log.py turns a captured log back into a binary trace
+static int cmd_trace_dump(const struct shell *sh, size_t argc, char **argv)
+{
+    char line[2 * 32 + 1];
+
+    for (size_t offset = 0; offset < trace_len; offset += 32)
+    {
+        size_t count = MIN(32, trace_len - offset);
+        bin2hex(&trace_buffer[offset], count, line, sizeof(line));
+        shell_print(sh, "trace: %s", line);
+    }
+
+    if (trace_dropped > 0)
+    {
+        shell_warn(sh, "%u records dropped, buffer too small", trace_dropped);
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(trace_cmds,
+                               SHELL_CMD(start, NULL, "Clear the buffer and start recording", cmd_trace_start),
+                               SHELL_CMD(stop, NULL, "Stop recording", cmd_trace_stop),
+                               SHELL_CMD(dump, NULL, "Print the recorded trace as hex", cmd_trace_dump),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle_screen), trace, &trace_cmds, "Event trace recording", NULL, 1, 0);
+
+#endif // CONFIG_SHELL
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/wpm_state_changed.h>
+#include <zmk/events/battery_state_changed.h>
+#include <zmk/events/endpoint_changed.h>
+#include <zmk/events/caps_word_state_changed.h>
+#include <zmk/keymap.h>
+#include <zmk/keys.h>
+#include <zmk/hid.h>
+
+#include <dongle_screen/memory_display.h>
+
+#include "event_trace.h"
+#include "event_trace_replay_bottom.h"
+#include "cmdline.h"
+#include "soc.h"
+#include "posix_board_if.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Time given to the display pipeline after the last event before the report is printed
+#define REPLAY_SETTLE_MS (4 * CONFIG_LV_DISP_DEF_REFR_PERIOD)
+
+static const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+static char *trace_path;
+static int32_t trace_speed = 100;
+static bool trace_exit;
+
+static uint8_t trace_buffer[CONFIG_DONGLE_SCREEN_EVENT_TRACE_REPLAY_MAX_SIZE];
+
+struct replay_stats
+{
+    uint32_t events;
+    uint32_t flushes;
+    uint64_t pixels;
+    uint32_t max_queue_depth;
+    uint32_t coalesced; // Display updates merged into an already queued one
+};
+
+static struct replay_stats stats[EVENT_TRACE_TYPE_COUNT];
+static uint32_t modifier_mismatches;
+
+static const char *const type_names[EVENT_TRACE_TYPE_COUNT] = {
+    [EVENT_TRACE_DELAY] = "delay",
+    [EVENT_TRACE_KEYCODE] = "keycode",
+    [EVENT_TRACE_LAYER] = "layer",
+    [EVENT_TRACE_WPM] = "wpm",
+    [EVENT_TRACE_MODIFIERS] = "modifiers",
+    [EVENT_TRACE_BATTERY] = "battery",
+    [EVENT_TRACE_ENDPOINT] = "endpoint",
+    [EVENT_TRACE_CAPS_WORD] = "caps_word",
+};
+
+// Event types with a display widget listening, used to detect coalesced updates
+static const bool type_has_widget[EVENT_TRACE_TYPE_COUNT] = {
+    [EVENT_TRACE_LAYER] = true,
+    [EVENT_TRACE_WPM] = true,
+    [EVENT_TRACE_BATTERY] = true,
+    [EVENT_TRACE_ENDPOINT] = true,
+    [EVENT_TRACE_CAPS_WORD] = true,
+};
+
+static uint32_t display_queue_depth(void)
+{
+    return sys_slist_len(&zmk_display_work_q()->pending);
+}
+
+// Returns false for records that are only kept in the trace for reference
+static bool replay_event(const struct event_trace_record *rec)
+{
+    switch (rec->type)
+    {
+    case EVENT_TRACE_KEYCODE:
+        raise_zmk_keycode_state_changed_from_encoded(ZMK_HID_USAGE(rec->arg >> 1, rec->value),
+                                                     rec->arg & 1, k_uptime_get());
+        break;
+    case EVENT_TRACE_LAYER:
+        if (rec->value)
+        {
+            zmk_keymap_layer_activate(rec->arg);
+        }
+        else
+        {
+            zmk_keymap_layer_deactivate(rec->arg);
+        }
+        break;
+    case EVENT_TRACE_WPM:
+#if IS_ENABLED(CONFIG_ZMK_WPM)
+        // The replayed keycodes already drive the WPM of ZMK, a second stream would fight it
+        return false;
+#else
+        raise_zmk_wpm_state_changed((struct zmk_wpm_state_changed){.state = rec->value});
+        break;
+#endif
+    case EVENT_TRACE_MODIFIERS:
+        // Modifiers are replayed through their keycodes, the record only verifies the HID state
+        if (zmk_hid_get_keyboard_report()->body.modifiers != rec->arg)
+        {
+            modifier_mismatches++;
+        }
+        break;
+    case EVENT_TRACE_BATTERY:
+        if (rec->arg == EVENT_TRACE_BATTERY_CENTRAL)
+        {
+            raise_zmk_battery_state_changed(
+                (struct zmk_battery_state_changed){.state_of_charge = rec->value});
+        }
+        else
+        {
+            raise_zmk_peripheral_battery_state_changed((struct zmk_peripheral_battery_state_changed){
+                .source = rec->arg, .state_of_charge = rec->value});
+        }
+        break;
+    case EVENT_TRACE_ENDPOINT:
+        raise_zmk_endpoint_changed((struct zmk_endpoint_changed){
+            .endpoint = {.transport = rec->arg, .ble = {.profile_index = rec->value}}});
+        break;
+    case EVENT_TRACE_CAPS_WORD:
+        raise_zmk_caps_word_state_changed((struct zmk_caps_word_state_changed){.active = rec->arg});
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+// Display work done since the previous snapshot is attributed to the event that preceded it
+static void attribute_work(int type, struct memory_display_stats *snapshot)
+{
+    struct memory_display_stats now;
+
+    memory_display_get_stats(display, &now);
+    if (type >= 0)
+    {
+        stats[type].flushes += now.flushes - snapshot->flushes;
+        stats[type].pixels += now.pixels - snapshot->pixels;
+    }
+    *snapshot = now;
+}
+
+static void replay_wait(uint32_t dt_ms)
+{
+    if (trace_speed > 0 && dt_ms > 0)
+    {
+        k_sleep(K_MSEC((uint64_t)dt_ms * 100 / trace_speed));
+    }
+}
+
+static void print_report(int64_t duration_ms)
+{
+    struct memory_display_stats total;
+
+    memory_display_get_stats(display, &total);
+
+    LOG_INF("Trace replay finished after %lld ms (speed %d%%)", duration_ms, trace_speed);
+    LOG_INF("%-10s %8s %8s %10s %8s %9s", "event", "count", "flushes", "pixels", "max_q", "coalesced");
+    for (int type = EVENT_TRACE_KEYCODE; type < EVENT_TRACE_TYPE_COUNT; type++)
+    {
+        if (stats[type].events == 0)
+        {
+            continue;
+        }
+        LOG_INF("%-10s %8u %8u %10llu %8u %9u", type_names[type], stats[type].events,
+                stats[type].flushes, stats[type].pixels, stats[type].max_queue_depth,
+                stats[type].coalesced);
+    }
+    LOG_INF("total flushes %u, pixels %llu, modifier mismatches %u", total.flushes, total.pixels,
+            modifier_mismatches);
+}
+
+static void event_trace_replay_thread(void)
+{
+    if (trace_path == NULL)
+    {
+        return;
+    }
+
+    int len = event_trace_read_bottom(trace_path, trace_buffer, sizeof(trace_buffer));
+    if (len < EVENT_TRACE_HEADER_SIZE || memcmp(trace_buffer, EVENT_TRACE_MAGIC, 4) != 0 ||
+        trace_buffer[4] != EVENT_TRACE_VERSION)
+    {
+        LOG_ERR("Couldn't read event trace %s (%d)", trace_path, len);
+        return;
+    }
+
+    while (!zmk_display_is_initialized())
+    {
+        k_sleep(K_MSEC(10));
+    }
+
+    struct memory_display_stats snapshot;
+    int last_type = -1;
+    int64_t start = k_uptime_get();
+
+    memory_display_get_stats(display, &snapshot);
+
+    for (int offset = EVENT_TRACE_HEADER_SIZE; offset + EVENT_TRACE_RECORD_SIZE <= len;
+         offset += EVENT_TRACE_RECORD_SIZE)
+    {
+        const uint8_t *raw = &trace_buffer[offset];
+        struct event_trace_record rec = {
+            .dt_ms = sys_get_le16(raw),
+            .type = raw[2],
+            .arg = raw[3],
+            .value = sys_get_le16(&raw[4]),
+        };
+
+        replay_wait(rec.dt_ms);
+
+        if (rec.type == EVENT_TRACE_DELAY || rec.type >= EVENT_TRACE_TYPE_COUNT)
+        {
+            continue;
+        }
+
+        attribute_work(last_type, &snapshot);
+
+        uint32_t depth_before = display_queue_depth();
+        if (!replay_event(&rec))
+        {
+            continue;
+        }
+        uint32_t depth_after = display_queue_depth();
+
+        stats[rec.type].events++;
+        stats[rec.type].max_queue_depth = MAX(stats[rec.type].max_queue_depth, depth_after);
+        if (type_has_widget[rec.type] && depth_after <= depth_before && depth_before > 0)
+        {
+            stats[rec.type].coalesced++;
+        }
+        last_type = rec.type;
+    }
+
+    k_sleep(K_MSEC(REPLAY_SETTLE_MS));
+    attribute_work(last_type, &snapshot);
+
+    print_report(k_uptime_get() - start);
+
+    if (trace_exit)
+    {
+        posix_exit(0);
+    }
+}
+
+// Cooperative priority, so the queue depth can be sampled before the display thread runs
+K_THREAD_DEFINE(event_trace_replay_tid, 2048, event_trace_replay_thread, NULL, NULL, NULL,
+                K_PRIO_COOP(10), 0, 0);
+
+static void event_trace_replay_native_options(void)
+{
+    static struct args_struct_t replay_options[] = {
+        {.option = "trace",
+         .name = "path",
+         .type = 's',
+         .dest = (void *)&trace_path,
+         .descript = "Event trace to replay through the widgets"},
+        {.option = "trace-speed",
+         .name = "percent",
+         .type = 'i',
+         .dest = (void *)&trace_speed,
+         .descript = "Replay speed in percent of the recorded timing, 0 = no delays (default 100)"},
+        {.is_switch = true,
+         .option = "trace-exit",
+         .type = 'b',
+         .dest = (void *)&trace_exit,
+         .descript = "Exit after the replay report has been printed"},
+        ARG_TABLE_ENDMARKER,
+    };
+
+    native_add_command_line_opts(replay_options);
+}
+
+NATIVE_TASK(event_trace_replay_native_options, PRE_BOOT_1, 1);
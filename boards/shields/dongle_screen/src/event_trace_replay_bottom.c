@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <stdio.h>
+
+#include "event_trace_replay_bottom.h"
+
+int event_trace_read_bottom(const char *path, uint8_t *buf, int max_len)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL)
+    {
+        return -errno;
+    }
+
+    size_t len = fread(buf, 1, max_len, file);
+    fclose(file);
+
+    return (int)len;
+}
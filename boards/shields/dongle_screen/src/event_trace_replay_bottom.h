@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Host side of the event trace replay, compiled against the host C library.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Read up to max_len bytes of a trace file
+ * @return Number of bytes read, or a negative host errno value
+ */
+int event_trace_read_bottom(const char *path, uint8_t *buf, int max_len);
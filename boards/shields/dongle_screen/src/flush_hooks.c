@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+
+#include <dongle_screen/flush_hooks.h>
+
+#include "latency.h"
+#include "telemetry.h"
+
+void dongle_screen_flush_begin(const struct device *dev, uint16_t x, uint16_t y, uint16_t width,
+                               uint16_t height)
+{
+    latency_flush_begin();
+    telemetry_flush_begin();
+}
+
+void dongle_screen_flush_end(const struct device *dev)
+{
+    latency_flush_end();
+    telemetry_flush_end();
+}
@@ -2,6 +2,8 @@
  * Size: 40 px
  * Bpp: 4
  * Opts: --bpp 4 --size 40 --no-compress --use-color-info --stride 1 --align 1 --font JetBrainsMonoNLNerdFontMono-Regular.ttf --symbols -^󰕓󰘳󰌽󰘴󰘵󰘶󰘲󰃚󰃛󰃜󰃝󰃞󰃟󰃠󰃡󰳲 --format lvgl -o NerdFonts_Regular_40.c
+ * The space (U+0020) was added by hand with the advance of Montserrat 40, so the modifier
+ * text doesn't need the fallback font
  ******************************************************************************/
 
 #include "lvgl.h"
@@ -934,7 +936,8 @@ static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {
     {.bitmap_index = 5637, .adv_w = 384, .box_w = 25, .box_h = 15, .ofs_x = 0, .ofs_y = 7},
     {.bitmap_index = 5825, .adv_w = 384, .box_w = 24, .box_h = 23, .ofs_x = 0, .ofs_y = 3},
     {.bitmap_index = 6101, .adv_w = 384, .box_w = 24, .box_h = 20, .ofs_x = 0, .ofs_y = 4},
-    {.bitmap_index = 6341, .adv_w = 384, .box_w = 25, .box_h = 25, .ofs_x = 0, .ofs_y = 2}
+    {.bitmap_index = 6341, .adv_w = 384, .box_w = 25, .box_h = 25, .ofs_x = 0, .ofs_y = 2},
+    {.bitmap_index = 0, .adv_w = 166, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* U+0020 " ", width of Montserrat 40 */
 };
 
 /*---------------------
@@ -950,9 +953,17 @@ static const uint16_t unicode_list_1[] = {
     0x263, 0x479, 0x558, 0x559, 0x55a, 0x55b, 0x55c, 0xc18
 };
 
+static const uint16_t unicode_list_space[] = {
+    0x0
+};
+
 /*Collect the unicode lists and glyph_id offsets*/
 static const lv_font_fmt_txt_cmap_t cmaps[] =
 {
+    {
+        .range_start = 32, .range_length = 1, .glyph_id_start = 23,
+        .unicode_list = unicode_list_space, .glyph_id_ofs_list = NULL, .list_length = 1, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY
+    },
     {
         .range_start = 45, .range_length = 62055, .glyph_id_start = 1,
         .unicode_list = unicode_list_0, .glyph_id_ofs_list = NULL, .list_length = 6, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY
@@ -984,7 +995,7 @@ static lv_font_fmt_txt_dsc_t font_dsc = {
     .cmaps = cmaps,
     .kern_dsc = NULL,
     .kern_scale = 0,
-    .cmap_num = 2,
+    .cmap_num = 3,
     .bpp = 4,
     .kern_classes = 0,
     .bitmap_format = 0,
@@ -994,7 +1005,9 @@ static lv_font_fmt_txt_dsc_t font_dsc = {
 
 };
 
+#if LV_FONT_MONTSERRAT_40
 extern const lv_font_t lv_font_montserrat_40;
+#endif
 
 
 /*-----------------
@@ -1019,7 +1032,7 @@ lv_font_t NerdFonts_Regular_40 = {
     .underline_thickness = 2,
 #endif
     .dsc = &font_dsc,          /*The custom font data. Will be accessed by `get_glyph_bitmap/dsc` */
-#if LV_VERSION_CHECK(8, 2, 0) || LVGL_VERSION_MAJOR >= 9
+#if (LV_VERSION_CHECK(8, 2, 0) || LVGL_VERSION_MAJOR >= 9) && LV_FONT_MONTSERRAT_40
     .fallback = &lv_font_montserrat_40,
 #endif
     .user_data = NULL,
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/shell/shell.h>
+
+#include <dongle_screen/memory_display.h>
+
+static const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+static int cmd_frame_dump(const struct shell *sh, size_t argc, char **argv)
+{
+    int ret = memory_display_dump(display, argc > 1 ? argv[1] : NULL);
+
+    if (ret < 0)
+    {
+        shell_error(sh, "Frame dump failed (%d)", ret);
+        return ret;
+    }
+
+    shell_print(sh, "Frame dumped");
+    return 0;
+}
+
+static int cmd_frame_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct memory_display_stats stats;
+
+    memory_display_get_stats(display, &stats);
+    shell_print(sh, "flushes: %u, pixels: %llu, dumps: %u", stats.flushes, stats.pixels, stats.dumps);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(frame_cmds,
+                               SHELL_CMD_ARG(dump, NULL, "Dump the current frame as PPM [path]", cmd_frame_dump, 1, 1),
+                               SHELL_CMD(stats, NULL, "Show flush statistics", cmd_frame_stats),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle_screen), frame, &frame_cmds, "Memory display frames", NULL, 1, 0);
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include "latency.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Bucket 0 is < 1 ms, bucket n covers [2^(n-1), 2^n) ms, the last one everything above
+#define LATENCY_BUCKETS 12
+
+enum latency_stage
+{
+    LATENCY_STAGE_QUEUE,
+    LATENCY_STAGE_RENDER,
+    LATENCY_STAGE_FLUSH,
+    LATENCY_STAGE_TOTAL,
+    LATENCY_STAGE_COUNT,
+};
+
+enum latency_progress
+{
+    LATENCY_IDLE,
+    LATENCY_QUEUED,   // event seen, waiting for the widget update
+    LATENCY_UPDATED,  // widget updated, waiting for the first flush
+    LATENCY_FLUSHING, // flushing, waiting for the last flush of the refresh
+};
+
+struct latency_measurement
+{
+    enum latency_progress progress;
+    int64_t event_us;
+    int64_t update_us;
+    int64_t flush_us;
+};
+
+struct latency_histogram
+{
+    uint32_t buckets[LATENCY_BUCKETS];
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t sum_us;
+};
+
+static const char *const widget_names[LATENCY_WIDGET_COUNT] = {
+    [LATENCY_WIDGET_LAYER] = "layer",
+    [LATENCY_WIDGET_MODS] = "mods",
+    [LATENCY_WIDGET_CAPS_WORD] = "caps_word",
+};
+
+static const char *const stage_names[LATENCY_STAGE_COUNT] = {
+    [LATENCY_STAGE_QUEUE] = "queue",
+    [LATENCY_STAGE_RENDER] = "render",
+    [LATENCY_STAGE_FLUSH] = "flush",
+    [LATENCY_STAGE_TOTAL] = "total",
+};
+
+static struct latency_measurement measurements[LATENCY_WIDGET_COUNT];
+static struct latency_histogram histograms[LATENCY_WIDGET_COUNT][LATENCY_STAGE_COUNT];
+static struct k_spinlock latency_lock;
+
+static int64_t latency_now_us(void)
+{
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static int latency_bucket(uint32_t us)
+{
+    uint32_t ms = us / 1000;
+
+    if (ms == 0)
+    {
+        return 0;
+    }
+    return MIN(32 - u32_count_leading_zeros(ms), LATENCY_BUCKETS - 1);
+}
+
+static void latency_record(struct latency_histogram *histogram, int64_t us)
+{
+    uint32_t value = CLAMP(us, 0, UINT32_MAX);
+
+    histogram->buckets[latency_bucket(value)]++;
+    histogram->count++;
+    histogram->sum_us += value;
+    histogram->max_us = MAX(histogram->max_us, value);
+}
+
+void latency_mark_event(enum latency_widget widget, int64_t timestamp_ms)
+{
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+    // Events arriving while a measurement is running are coalesced into it
+    if (measurements[widget].progress == LATENCY_IDLE)
+    {
+        measurements[widget].event_us = timestamp_ms * USEC_PER_MSEC;
+        measurements[widget].progress = LATENCY_QUEUED;
+    }
+
+    k_spin_unlock(&latency_lock, key);
+}
+
+void latency_mark_update(enum latency_widget widget)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+    if (measurements[widget].progress == LATENCY_QUEUED)
+    {
+        // Nothing invalidated means nothing will be flushed, so there is no photon to wait for
+        if (disp != NULL && disp->inv_p == 0)
+        {
+            measurements[widget].progress = LATENCY_IDLE;
+        }
+        else
+        {
+            measurements[widget].update_us = latency_now_us();
+            measurements[widget].progress = LATENCY_UPDATED;
+        }
+    }
+
+    k_spin_unlock(&latency_lock, key);
+}
+
+void latency_flush_begin(void)
+{
+    int64_t now = latency_now_us();
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+    for (int widget = 0; widget < LATENCY_WIDGET_COUNT; widget++)
+    {
+        if (measurements[widget].progress == LATENCY_UPDATED)
+        {
+            measurements[widget].flush_us = now;
+            measurements[widget].progress = LATENCY_FLUSHING;
+        }
+    }
+
+    k_spin_unlock(&latency_lock, key);
+}
+
+void latency_flush_end(void)
+{
+    // A refresh may be sent in several flushes, the widget is only complete after the last one
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    if (disp != NULL && !lv_disp_flush_is_last(disp->driver))
+    {
+        return;
+    }
+
+    int64_t now = latency_now_us();
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+    for (int widget = 0; widget < LATENCY_WIDGET_COUNT; widget++)
+    {
+        struct latency_measurement *m = &measurements[widget];
+        if (m->progress != LATENCY_FLUSHING)
+        {
+            continue;
+        }
+
+        latency_record(&histograms[widget][LATENCY_STAGE_QUEUE], m->update_us - m->event_us);
+        latency_record(&histograms[widget][LATENCY_STAGE_RENDER], m->flush_us - m->update_us);
+        latency_record(&histograms[widget][LATENCY_STAGE_FLUSH], now - m->flush_us);
+        latency_record(&histograms[widget][LATENCY_STAGE_TOTAL], now - m->event_us);
+        m->progress = LATENCY_IDLE;
+    }
+
+    k_spin_unlock(&latency_lock, key);
+}
+
+static void latency_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+    memset(histograms, 0, sizeof(histograms));
+    k_spin_unlock(&latency_lock, key);
+}
+
+static void latency_snapshot(struct latency_histogram snapshot[LATENCY_STAGE_COUNT],
+                             enum latency_widget widget)
+{
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+    memcpy(snapshot, histograms[widget], sizeof(histograms[widget]));
+    k_spin_unlock(&latency_lock, key);
+}
+
+// "total  n=12 avg=23.4 max=41.0 ms | <16:3 <32:8 <64:1"
+static void latency_format(char *buf, size_t len, enum latency_stage stage,
+                           const struct latency_histogram *histogram)
+{
+    uint32_t avg_us = histogram->sum_us / histogram->count;
+    int pos = snprintf(buf, len, "%-6s n=%u avg=%u.%u max=%u.%u ms |", stage_names[stage],
+                       histogram->count, avg_us / 1000, (avg_us % 1000) / 100,
+                       histogram->max_us / 1000, (histogram->max_us % 1000) / 100);
+
+    for (int bucket = 0; bucket < LATENCY_BUCKETS && pos < (int)len; bucket++)
+    {
+        if (histogram->buckets[bucket] == 0)
+        {
+            continue;
+        }
+        if (bucket == LATENCY_BUCKETS - 1)
+        {
+            pos += snprintf(&buf[pos], len - pos, " >=%lu:%u", BIT(bucket - 1),
+                            histogram->buckets[bucket]);
+        }
+        else
+        {
+            pos += snprintf(&buf[pos], len - pos, " <%lu:%u", BIT(bucket),
+                            histogram->buckets[bucket]);
+        }
+    }
+}
+
+#if CONFIG_DONGLE_SCREEN_LATENCY_LOG_INTERVAL_S > 0
+
+static void latency_log_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(latency_log_work, latency_log_work_handler);
+
+static void latency_log_work_handler(struct k_work *work)
+{
+    struct latency_histogram snapshot[LATENCY_STAGE_COUNT];
+    char line[128];
+
+    for (int widget = 0; widget < LATENCY_WIDGET_COUNT; widget++)
+    {
+        latency_snapshot(snapshot, widget);
+        if (snapshot[LATENCY_STAGE_TOTAL].count == 0)
+        {
+            continue;
+        }
+        for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+        {
+            latency_format(line, sizeof(line), stage, &snapshot[stage]);
+            LOG_INF("Latency %s %s", widget_names[widget], line);
+        }
+    }
+
+    k_work_schedule(&latency_log_work, K_SECONDS(CONFIG_DONGLE_SCREEN_LATENCY_LOG_INTERVAL_S));
+}
+
+static int latency_init(void)
+{
+    k_work_schedule(&latency_log_work, K_SECONDS(CONFIG_DONGLE_SCREEN_LATENCY_LOG_INTERVAL_S));
+    return 0;
+}
+
+SYS_INIT(latency_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // CONFIG_DONGLE_SCREEN_LATENCY_LOG_INTERVAL_S > 0
+
+#if IS_ENABLED(CONFIG_SHELL)
+
+static int cmd_latency_show(const struct shell *sh, size_t argc, char **argv)
+{
+    struct latency_histogram snapshot[LATENCY_STAGE_COUNT];
+    char line[128];
+
+    for (int widget = 0; widget < LATENCY_WIDGET_COUNT; widget++)
+    {
+        latency_snapshot(snapshot, widget);
+        if (snapshot[LATENCY_STAGE_TOTAL].count == 0)
+        {
+            shell_print(sh, "%s: no samples", widget_names[widget]);
+            continue;
+        }
+
+        shell_print(sh, "%s:", widget_names[widget]);
+        for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+        {
+            latency_format(line, sizeof(line), stage, &snapshot[stage]);
+            shell_print(sh, "  %s", line);
+        }
+    }
+    return 0;
+}
+
+static int cmd_latency_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    latency_reset();
+    shell_print(sh, "Latency histograms cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(latency_cmds,
+                               SHELL_CMD(reset, NULL, "Clear the histograms", cmd_latency_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle_screen), latency, &latency_cmds, "Show key-to-photon latency histograms",
+                 cmd_latency_show, 1, 0);
+
+#endif // CONFIG_SHELL
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * Key-to-photon latency of the indicator widgets, split into stages:
+ *
+ *   queue:  triggering event -> widget update callback on the display work queue
+ *   render: update callback  -> first flush to the panel
+ *   flush:  first flush      -> completion of the last display_write() of that refresh
+ *   total:  triggering event -> completion of the last display_write()
+ */
+enum latency_widget
+{
+    LATENCY_WIDGET_LAYER,
+    LATENCY_WIDGET_MODS,
+    LATENCY_WIDGET_CAPS_WORD,
+    LATENCY_WIDGET_COUNT,
+};
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_LATENCY)
+
+/**
+ * @brief Start a measurement for the widget, called from the listener of the triggering event
+ * @param timestamp_ms Uptime of the triggering event (e.g. the event's timestamp field)
+ */
+void latency_mark_event(enum latency_widget widget, int64_t timestamp_ms);
+
+/**
+ * @brief The widget applied the new state to its LVGL objects
+ */
+void latency_mark_update(enum latency_widget widget);
+
+void latency_flush_begin(void);
+void latency_flush_end(void);
+
+#else
+
+static inline void latency_mark_event(enum latency_widget widget, int64_t timestamp_ms) {}
+static inline void latency_mark_update(enum latency_widget widget) {}
+static inline void latency_flush_begin(void) {}
+static inline void latency_flush_end(void) {}
+
+#endif
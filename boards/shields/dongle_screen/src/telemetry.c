@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include "telemetry.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Bucket 0 is off, bucket n covers duty cycles up to n quarters of the maximum
+#define TELEMETRY_DUTY_BUCKETS 5
+#define TELEMETRY_MS_PER_HOUR (60 * 60 * 1000)
+
+struct telemetry_counters
+{
+    uint64_t backlight_ms[TELEMETRY_DUTY_BUCKETS];
+    uint64_t backlight_duty_ms; // Sum of duty * ms, 65535 * ms is one ms at full duty
+    uint64_t panel_on_ms;
+    uint64_t panel_sleep_ms;
+    uint64_t render_ms;
+    uint64_t spi_us;
+    uint32_t backlight_changes;
+    uint32_t fades;
+    uint32_t panel_wakes;
+    uint32_t renders;
+    uint32_t flushes;
+    int64_t start_ms;
+    int64_t end_ms; // Only set in snapshots
+};
+
+static struct telemetry_counters counters;
+static struct k_spinlock telemetry_lock;
+
+// Open intervals, closed on every change and for snapshots
+static uint16_t backlight_duty;
+static int64_t backlight_since_ms;
+static bool panel_awake = true;
+static int64_t panel_since_ms;
+static uint32_t flush_start_cycles;
+
+static int telemetry_duty_bucket(uint16_t duty)
+{
+    if (duty == 0)
+    {
+        return 0;
+    }
+    return 1 + ((uint32_t)duty * 4 - 1) / (UINT16_MAX + 1);
+}
+
+static void telemetry_close_backlight(struct telemetry_counters *c, int64_t now)
+{
+    int64_t elapsed = now - backlight_since_ms;
+
+    c->backlight_ms[telemetry_duty_bucket(backlight_duty)] += elapsed;
+    c->backlight_duty_ms += (uint64_t)backlight_duty * elapsed;
+}
+
+static void telemetry_close_panel(struct telemetry_counters *c, int64_t now)
+{
+    if (panel_awake)
+    {
+        c->panel_on_ms += now - panel_since_ms;
+    }
+    else
+    {
+        c->panel_sleep_ms += now - panel_since_ms;
+    }
+}
+
+void telemetry_backlight(uint16_t duty, bool fade)
+{
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&telemetry_lock);
+
+    // Fades are accounted at their target, they are short compared to the time in between
+    telemetry_close_backlight(&counters, now);
+    backlight_duty = duty;
+    backlight_since_ms = now;
+    counters.backlight_changes++;
+    if (fade)
+    {
+        counters.fades++;
+    }
+
+    k_spin_unlock(&telemetry_lock, key);
+}
+
+void telemetry_panel(bool awake)
+{
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&telemetry_lock);
+
+    if (awake != panel_awake)
+    {
+        telemetry_close_panel(&counters, now);
+        panel_awake = awake;
+        panel_since_ms = now;
+        if (awake)
+        {
+            counters.panel_wakes++;
+        }
+    }
+
+    k_spin_unlock(&telemetry_lock, key);
+}
+
+static void telemetry_monitor_cb(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
+{
+    k_spinlock_key_t key = k_spin_lock(&telemetry_lock);
+    counters.render_ms += time;
+    counters.renders++;
+    k_spin_unlock(&telemetry_lock, key);
+}
+
+void telemetry_attach_display(void)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+
+    if (disp != NULL)
+    {
+        disp->driver->monitor_cb = telemetry_monitor_cb;
+    }
+}
+
+void telemetry_flush_begin(void)
+{
+    flush_start_cycles = k_cycle_get_32();
+}
+
+void telemetry_flush_end(void)
+{
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - flush_start_cycles);
+    k_spinlock_key_t key = k_spin_lock(&telemetry_lock);
+    counters.spi_us += us;
+    counters.flushes++;
+    k_spin_unlock(&telemetry_lock, key);
+}
+
+static void telemetry_snapshot(struct telemetry_counters *snapshot)
+{
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&telemetry_lock);
+
+    *snapshot = counters;
+    telemetry_close_backlight(snapshot, now);
+    telemetry_close_panel(snapshot, now);
+    snapshot->end_ms = now;
+
+    k_spin_unlock(&telemetry_lock, key);
+}
+
+static void telemetry_reset(void)
+{
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&telemetry_lock);
+
+    counters = (struct telemetry_counters){.start_ms = now};
+    backlight_since_ms = now;
+    panel_since_ms = now;
+
+    k_spin_unlock(&telemetry_lock, key);
+}
+
+// Charge in uA * ms per state of the current model
+static uint64_t telemetry_charge_backlight(const struct telemetry_counters *c)
+{
+    return c->backlight_duty_ms / UINT16_MAX * CONFIG_DONGLE_SCREEN_TELEMETRY_BACKLIGHT_UA;
+}
+
+static uint64_t telemetry_charge_panel(const struct telemetry_counters *c)
+{
+    return c->panel_on_ms * CONFIG_DONGLE_SCREEN_TELEMETRY_PANEL_ON_UA +
+           c->panel_sleep_ms * CONFIG_DONGLE_SCREEN_TELEMETRY_PANEL_SLEEP_UA;
+}
+
+static uint64_t telemetry_charge_render(const struct telemetry_counters *c)
+{
+    return c->render_ms * CONFIG_DONGLE_SCREEN_TELEMETRY_RENDER_UA;
+}
+
+static uint64_t telemetry_charge_spi(const struct telemetry_counters *c)
+{
+    return c->spi_us / USEC_PER_MSEC * CONFIG_DONGLE_SCREEN_TELEMETRY_SPI_UA;
+}
+
+// "1.234" mAh from uA * ms
+static void telemetry_format_mah(char *buf, size_t len, uint64_t ua_ms)
+{
+    uint64_t uah = ua_ms / TELEMETRY_MS_PER_HOUR;
+    snprintf(buf, len, "%u.%03u", (uint32_t)(uah / 1000), (uint32_t)(uah % 1000));
+}
+
+static uint32_t telemetry_percent(uint64_t part, uint64_t total)
+{
+    return total > 0 ? part * 100 / total : 0;
+}
+
+// Fills one report line, returns false after the last one
+static bool telemetry_format(char *buf, size_t len, int line, const struct telemetry_counters *c)
+{
+    uint64_t elapsed_ms = MAX(c->end_ms - c->start_ms, 1);
+    char total[16], backlight[16], panel[16], render[16], spi[16];
+
+    switch (line)
+    {
+    case 0:
+    {
+        uint64_t charge = telemetry_charge_backlight(c) + telemetry_charge_panel(c) +
+                          telemetry_charge_render(c) + telemetry_charge_spi(c);
+        telemetry_format_mah(total, sizeof(total), charge);
+        snprintf(buf, len, "%u s, estimated %s mAh (avg %u uA)", (uint32_t)(elapsed_ms / 1000),
+                 total, (uint32_t)(charge / elapsed_ms));
+        return true;
+    }
+    case 1:
+        snprintf(buf, len, "backlight off:%u%% <=25:%u%% <=50:%u%% <=75:%u%% <=100:%u%%, %u changes, %u fades",
+                 telemetry_percent(c->backlight_ms[0], elapsed_ms),
+                 telemetry_percent(c->backlight_ms[1], elapsed_ms),
+                 telemetry_percent(c->backlight_ms[2], elapsed_ms),
+                 telemetry_percent(c->backlight_ms[3], elapsed_ms),
+                 telemetry_percent(c->backlight_ms[4], elapsed_ms), c->backlight_changes, c->fades);
+        return true;
+    case 2:
+        snprintf(buf, len, "panel on:%u%% sleep:%u%%, %u wakes, render %u ms in %u refreshes, spi %u ms in %u flushes",
+                 telemetry_percent(c->panel_on_ms, elapsed_ms),
+                 telemetry_percent(c->panel_sleep_ms, elapsed_ms), c->panel_wakes,
+                 (uint32_t)c->render_ms, c->renders, (uint32_t)(c->spi_us / USEC_PER_MSEC), c->flushes);
+        return true;
+    case 3:
+        telemetry_format_mah(backlight, sizeof(backlight), telemetry_charge_backlight(c));
+        telemetry_format_mah(panel, sizeof(panel), telemetry_charge_panel(c));
+        telemetry_format_mah(render, sizeof(render), telemetry_charge_render(c));
+        telemetry_format_mah(spi, sizeof(spi), telemetry_charge_spi(c));
+        snprintf(buf, len, "mAh backlight %s, panel %s, render %s, spi %s", backlight, panel, render, spi);
+        return true;
+    default:
+        return false;
+    }
+}
+
+#if CONFIG_DONGLE_SCREEN_TELEMETRY_LOG_INTERVAL_S > 0
+
+static void telemetry_log_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(telemetry_log_work, telemetry_log_work_handler);
+
+static void telemetry_log_work_handler(struct k_work *work)
+{
+    struct telemetry_counters snapshot;
+    char line[128];
+
+    telemetry_snapshot(&snapshot);
+    for (int i = 0; telemetry_format(line, sizeof(line), i, &snapshot); i++)
+    {
+        LOG_INF("Telemetry %s", line);
+    }
+
+    k_work_schedule(&telemetry_log_work, K_SECONDS(CONFIG_DONGLE_SCREEN_TELEMETRY_LOG_INTERVAL_S));
+}
+
+static int telemetry_init(void)
+{
+    k_work_schedule(&telemetry_log_work, K_SECONDS(CONFIG_DONGLE_SCREEN_TELEMETRY_LOG_INTERVAL_S));
+    return 0;
+}
+
+SYS_INIT(telemetry_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // CONFIG_DONGLE_SCREEN_TELEMETRY_LOG_INTERVAL_S > 0
+
+#if IS_ENABLED(CONFIG_SHELL)
+
+static int cmd_telemetry_show(const struct shell *sh, size_t argc, char **argv)
+{
+    struct telemetry_counters snapshot;
+    char line[128];
+
+    telemetry_snapshot(&snapshot);
+    for (int i = 0; telemetry_format(line, sizeof(line), i, &snapshot); i++)
+    {
+        shell_print(sh, "%s", line);
+    }
+    return 0;
+}
+
+static int cmd_telemetry_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    telemetry_reset();
+    shell_print(sh, "Telemetry counters cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(telemetry_cmds,
+                               SHELL_CMD(reset, NULL, "Clear the counters", cmd_telemetry_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle_screen), telemetry, &telemetry_cmds,
+                 "Show backlight and display power telemetry", cmd_telemetry_show, 1, 0);
+
+#endif // CONFIG_SHELL
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * Time spent by the backlight in duty buckets, by the panel awake and asleep, by LVGL rendering
+ * and by SPI flushes. A per-state current model from Kconfig turns it into an estimated charge.
+ */
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_TELEMETRY)
+
+/**
+ * @brief The backlight output changed
+ * @param duty New duty cycle 0..65535, the target duty for fades
+ * @param fade Whether the change is a fade
+ */
+void telemetry_backlight(uint16_t duty, bool fade);
+
+/**
+ * @brief The panel was woken up or put to sleep
+ */
+void telemetry_panel(bool awake);
+
+/**
+ * @brief Install the LVGL monitor callback that accounts the render time
+ * Must be called from the display work queue after the display is initialized
+ */
+void telemetry_attach_display(void);
+
+void telemetry_flush_begin(void);
+void telemetry_flush_end(void);
+
+#else
+
+static inline void telemetry_backlight(uint16_t duty, bool fade) {}
+static inline void telemetry_panel(bool awake) {}
+static inline void telemetry_attach_display(void) {}
+static inline void telemetry_flush_begin(void) {}
+static inline void telemetry_flush_end(void) {}
+
+#endif
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
 #include <zephyr/bluetooth/services/bas.h>
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -20,6 +21,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/usb.h>
 
 #include "battery_status.h"
+#include "shadow_label.h"
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_ESTIMATE)
+#include "../battery_history.h"
+#endif
 #include "../brightness.h"
 
 // 💡 커스텀 폰트 선언
@@ -33,10 +38,90 @@ LV_FONT_DECLARE(NerdFonts_Regular_20);
 
 #define BATTERY_TEXT_COLOR_HEX 0xFFFFFF // ✅ 흰색 숫자
 #define BATTERY_SHADOW_COLOR_HEX 0x282828 // ⭐ 회색빛 숫자 그림자 
-#define BATTERY_WIDTH 90
-#define BATTERY_HEIGHT 20
+#define BATTERY_COUNT (ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT + SOURCE_OFFSET)
+
+// 📐 가로 화면이면 패널의 height가 화면 폭
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_HORIZONTAL)
+    #define SCREEN_WIDTH DT_PROP(DT_CHOSEN(zephyr_display), height)
+#else
+    #define SCREEN_WIDTH DT_PROP(DT_CHOSEN(zephyr_display), width)
+#endif
+#define CONTAINER_WIDTH (SCREEN_WIDTH - 20)
+#define LAYOUT_FITS(width, gap) (BATTERY_COUNT * (width) + (BATTERY_COUNT - 1) * (gap) <= CONTAINER_WIDTH)
+
+// 🔹 외곽/막대 사각형 (캔버스 좌표)
+struct battery_rect {
+    lv_coord_t x, y, w, h, radius;
+};
+
+// 🔹 배터리 아이콘 크기별 배치
+struct battery_layout {
+    struct battery_rect border;   // 흰색 테두리
+    struct battery_rect terminal; // +극 돌출부
+    struct battery_rect inner;    // 내부 검정 공백
+    struct battery_rect bar;      // 막대
+    const lv_font_t *font;
+    const char *sleep_text;       // 0% (슬립) 표시, 막대 폭 안에 들어가야 함
+    lv_coord_t label_ofs;         // 숫자 위치 (가운데 기준)
+    lv_coord_t shadow_ofs;        // 그림자 거리
+};
+
+// 📐 빌드 시 소스 수와 화면 폭에 맞는 가장 큰 아이콘 선택
+#if LAYOUT_FITS(118, 18)
+// 🔋 full: 1~2개
 #define CANVAS_WIDTH 118
 #define CANVAS_HEIGHT 32
+#define CANVAS_GAP 18
+static const struct battery_layout layout = {
+    .border = {8, 0, 102, 32, 7},
+    .terminal = {113, 10, 3, 12, 0},
+    .inner = {10, 2, 98, 28, 6},
+    .bar = {14, 6, 90, 20, 3},
+    .font = &NerdFonts_Regular_20,
+    .sleep_text = "sleep",
+    .label_ofs = -1,
+    .shadow_ofs = 2,
+};
+#elif LAYOUT_FITS(72, 12)
+// 🔋 compact: 3개 정도
+#define CANVAS_WIDTH 72
+#define CANVAS_HEIGHT 24
+#define CANVAS_GAP 12
+static const struct battery_layout layout = {
+    .border = {0, 0, 68, 24, 5},
+    .terminal = {70, 7, 2, 10, 0},
+    .inner = {2, 2, 64, 20, 4},
+    .bar = {4, 4, 60, 16, 2},
+    .font = &NerdFonts_Regular_20,
+    .sleep_text = "sleep",
+    .label_ofs = -1,
+    .shadow_ofs = 2,
+};
+#else
+// 🔋 minimal: 4개 이상 (숫자는 unscii 8)
+#define CANVAS_WIDTH 40
+#define CANVAS_HEIGHT 14
+#define CANVAS_GAP 4
+static const struct battery_layout layout = {
+    .border = {0, 0, 36, 14, 3},
+    .terminal = {37, 4, 2, 6, 0},
+    .inner = {1, 1, 34, 12, 2},
+    .bar = {2, 2, 32, 10, 1},
+    .font = &lv_font_unscii_8,
+    .sleep_text = "zz", // unscii 8은 글자당 8px, "sleep"(40px)은 32px 막대를 넘음
+    .label_ofs = 0,
+    .shadow_ofs = 1,
+};
+#endif
+
+BUILD_ASSERT(LAYOUT_FITS(CANVAS_WIDTH, CANVAS_GAP),
+             "Too many battery sources for the screen width, even with the minimal battery icons");
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_ESTIMATE)
+    #define ESTIMATE_HEIGHT 12 // ⏳ 배터리 위 남은 시간 줄
+#else
+    #define ESTIMATE_HEIGHT 0
+#endif
 
 static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
@@ -48,18 +133,24 @@ struct battery_state {
 
 // 🔹 배터리 위젯 구조체
 struct battery_object {
-    lv_obj_t *symbol;         // 배터리 캔버스
-    lv_obj_t *label;          // 밝은 숫자
-    lv_obj_t *label_shadow;   // 그림자 숫자
+    lv_obj_t *symbol;         // 배터리 외곽 이미지 (공유)
+    lv_obj_t *bar;            // 어두운 배경 막대
+    lv_obj_t *fill;           // 밝은 채움 막대
+    lv_obj_t *label;          // 밝은 숫자 + 그림자 (한 번에 그림)
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_ESTIMATE)
+    lv_obj_t *estimate;       // 남은 시간
+#endif
 };
 
-static struct battery_object battery_objects[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT + SOURCE_OFFSET];
-static lv_color_t battery_image_buffer[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT + SOURCE_OFFSET][CANVAS_WIDTH * CANVAS_HEIGHT];
-static int8_t last_battery_levels[ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT + SOURCE_OFFSET];
+static struct battery_object battery_objects[BATTERY_COUNT];
+// 🖼 외곽 이미지는 모든 소스가 하나의 버퍼를 공유 (막대는 버퍼 없는 lv_obj)
+static lv_color_t battery_outline_buffer[CANVAS_WIDTH * CANVAS_HEIGHT];
+static lv_img_dsc_t battery_outline_img;
+static int8_t last_battery_levels[BATTERY_COUNT];
 
 // ⚠️ 초기화: 모든 배터리 레벨을 -1로 초기화
 static void init_peripheral_tracking(void) {
-    for (int i = 0; i < (ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT + SOURCE_OFFSET); i++)
+    for (int i = 0; i < BATTERY_COUNT; i++)
         last_battery_levels[i] = -1;
 }
 
@@ -81,87 +172,139 @@ static lv_color_t battery_color_dark(uint8_t level) {
     return lv_color_hex(0x04910A);
 }
 
-// 🔹 배터리 캔버스 그리기
-static void draw_battery(lv_obj_t *canvas, uint8_t level) {
-    lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_TRANSP);
-    lv_draw_rect_dsc_t rect_dsc;
+// 🔹 색상 구간 (같은 구간이면 채움/배경 색이 같음)
+static uint8_t battery_color_class(uint8_t level) {
+    if (level < 1) return 0;
+    if (level <= 10) return 1;
+    if (level <= 15) return 2;
+    if (level <= 20) return 3;
+    return 4;
+}
 
-    // ✅ 외곽 흰색 테두리
+// 🔹 레벨 → 채움 픽셀 폭
+static int battery_pixel_width(uint8_t level) {
+    return (layout.bar.w * MIN(level, 100)) / 100;
+}
+
+// 🔹 사각형 하나 그리기
+static void draw_battery_rect(lv_obj_t *canvas, const struct battery_rect *rect, lv_color_t color) {
+    lv_draw_rect_dsc_t rect_dsc;
     lv_draw_rect_dsc_init(&rect_dsc);
-    rect_dsc.bg_color = lv_color_hex(0xFFFFFF);
+    rect_dsc.bg_color = color;
     rect_dsc.bg_opa = LV_OPA_COVER;
-    rect_dsc.radius = 7;
-    lv_canvas_draw_rect(canvas, 8, 0, 102, 32, &rect_dsc);
+    rect_dsc.radius = rect->radius;
+    lv_canvas_draw_rect(canvas, rect->x, rect->y, rect->w, rect->h, &rect_dsc);
+}
+
+// 🔹 배터리 외곽 그리기 (레벨과 무관, 초기화 때 한 번만)
+static void draw_battery_outline(lv_obj_t *canvas) {
+    lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_TRANSP);
+
+    // ✅ 외곽 흰색 테두리
+    draw_battery_rect(canvas, &layout.border, lv_color_hex(0xFFFFFF));
 
     // ⚡ +극 돌출부
-    lv_draw_rect_dsc_init(&rect_dsc);
-    rect_dsc.bg_color = lv_color_hex(0xFFFFFF);
-    rect_dsc.bg_opa = LV_OPA_COVER;
-    lv_canvas_draw_rect(canvas, 113, 10, 3, 12, &rect_dsc);
+    draw_battery_rect(canvas, &layout.terminal, lv_color_hex(0xFFFFFF));
 
     // 🖤 오른쪽 둥근 모서리
     lv_color_t black = lv_color_hex(0x000000);
-    lv_canvas_set_px(canvas, 115, 10, black);
-    lv_canvas_set_px(canvas, 115, 21, black);
-    
+    lv_coord_t terminal_right = layout.terminal.x + layout.terminal.w - 1;
+    lv_canvas_set_px(canvas, terminal_right, layout.terminal.y, black);
+    lv_canvas_set_px(canvas, terminal_right, layout.terminal.y + layout.terminal.h - 1, black);
+
     // ⚫ 내부 검정 공백
-    lv_draw_rect_dsc_init(&rect_dsc);
-    rect_dsc.bg_color = lv_color_hex(0x000000);
-    rect_dsc.bg_opa = LV_OPA_COVER;
-    rect_dsc.radius = 6;
-    lv_canvas_draw_rect(canvas, 10, 2, 98, 28, &rect_dsc);
+    draw_battery_rect(canvas, &layout.inner, black);
+}
 
-    // 🔹 어두운 배경
-    lv_draw_rect_dsc_init(&rect_dsc);
-    rect_dsc.bg_color = battery_color_dark(level);
-    rect_dsc.bg_opa = LV_OPA_COVER;
-    rect_dsc.radius = 3;
-    lv_canvas_draw_rect(canvas, 14, 6, BATTERY_WIDTH, BATTERY_HEIGHT, &rect_dsc);
-
-    // 🔆 밝은 채움
-    if (level > 0) {
-        uint8_t width = (level > 100 ? 100 : level);
-        uint8_t pixel_width = (uint8_t)((BATTERY_WIDTH * width) / 100);
-        lv_draw_rect_dsc_init(&rect_dsc);
-        rect_dsc.bg_color = battery_color(level);
-        rect_dsc.bg_opa = LV_OPA_COVER;
-        rect_dsc.radius = 3;
-        lv_canvas_draw_rect(canvas, 14, 6, pixel_width, BATTERY_HEIGHT, &rect_dsc);
+// 🔹 외곽 이미지 준비 (임시 캔버스로 한 번만 그림)
+static void init_battery_outline(lv_obj_t *parent) {
+    if (battery_outline_img.data != NULL) return;
+
+    lv_obj_t *canvas = lv_canvas_create(parent);
+    lv_canvas_set_buffer(canvas, battery_outline_buffer, CANVAS_WIDTH, CANVAS_HEIGHT, LV_IMG_CF_TRUE_COLOR);
+    draw_battery_outline(canvas);
+    lv_obj_del(canvas);
+
+    battery_outline_img.header.cf = LV_IMG_CF_TRUE_COLOR;
+    battery_outline_img.header.w = CANVAS_WIDTH;
+    battery_outline_img.header.h = CANVAS_HEIGHT;
+    battery_outline_img.data_size = sizeof(battery_outline_buffer);
+    battery_outline_img.data = (const uint8_t *)battery_outline_buffer;
+}
+
+// 🔹 둥근 막대 객체 생성 (스타일만 있고 버퍼 없음)
+static lv_obj_t *create_battery_bar(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, lv_coord_t w) {
+    lv_obj_t *bar = lv_obj_create(parent);
+    lv_obj_remove_style_all(bar);
+    lv_obj_clear_flag(bar, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(bar, layout.bar.radius, 0);
+    lv_obj_set_pos(bar, x, y);
+    lv_obj_set_size(bar, w, layout.bar.h);
+    return bar;
+}
+
+// 🔹 막대 갱신: 색 구간이 바뀔 때만 색을, 픽셀 폭이 바뀔 때만 채움 폭을 변경
+static void update_battery_bar(struct battery_object *obj, int8_t old_level, uint8_t level) {
+    if (old_level < 0 || battery_color_class(old_level) != battery_color_class(level)) {
+        lv_obj_set_style_bg_color(obj->bar, battery_color_dark(level), 0);
+        lv_obj_set_style_bg_color(obj->fill, battery_color(level), 0);
+    }
+
+    // 🔆 채움 폭이 바뀌면 LVGL이 채움 객체의 이전/새 영역만 무효화
+    if (old_level < 0 || battery_pixel_width(old_level) != battery_pixel_width(level)) {
+        lv_obj_set_width(obj->fill, battery_pixel_width(level));
+    }
+}
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_ESTIMATE)
+// ⏳ 남은 시간 표시 (추세가 없으면 비움)
+static void set_battery_estimate(lv_obj_t *estimate, uint8_t source, uint8_t level) {
+    battery_history_add(source, level);
+    int32_t minutes = battery_history_remaining_min(source);
+
+    if (minutes < 0) {
+        lv_label_set_text(estimate, "");
+    } else if (minutes < 60) {
+        lv_label_set_text_fmt(estimate, "~%dm", minutes);
+    } else if (minutes < 48 * 60) {
+        lv_label_set_text_fmt(estimate, "~%dh", minutes / 60);
+    } else {
+        lv_label_set_text_fmt(estimate, "~%dd", minutes / (24 * 60));
     }
 }
+#endif
 
 // 🔹 배터리 심볼 + 레이블 + 그림자 업데이트
 static void set_battery_symbol(lv_obj_t *widget, struct battery_state state) {
-    if (state.source >= ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT + SOURCE_OFFSET) return;
+    if (state.source >= BATTERY_COUNT) return;
 
+    // ⏭ 표시 중인 값과 같으면 아무것도 하지 않음 (주기적 배터리 보고)
+    int8_t old_level = last_battery_levels[state.source];
+    if (old_level == state.level) return;
     last_battery_levels[state.source] = state.level;
 
     lv_obj_t *symbol = battery_objects[state.source].symbol;
     lv_obj_t *label = battery_objects[state.source].label;
-    lv_obj_t *label_shadow = battery_objects[state.source].label_shadow;
 
-    draw_battery(symbol, state.level);
+    update_battery_bar(&battery_objects[state.source], old_level, state.level);
 
-    // 💡 텍스트 설정 (그림자 → 흰색 순으로)
+    // 💡 텍스트 설정, 레벨이 바뀌었으므로 글자도 바뀜
     if (state.level < 1) {
-        lv_label_set_text(label_shadow, "sleep");
-        lv_label_set_text(label, "sleep");
+        lv_label_set_text_static(label, layout.sleep_text);
     } else {
-        lv_label_set_text_fmt(label_shadow, "%u", state.level);
         lv_label_set_text_fmt(label, "%u", state.level);
     }
 
-    // 📌 위치 조정
-    lv_obj_align(label_shadow, LV_ALIGN_CENTER, 1, 1); // 숫자 그림자 위치
-    lv_obj_align(label, LV_ALIGN_CENTER, -1, -1);       // 흰색 숫자 위치
-
-    // 🔄 표시 갱신
-    lv_obj_clear_flag(symbol, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_move_foreground(symbol);
-    lv_obj_clear_flag(label_shadow, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_move_foreground(label_shadow);
-    lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_move_foreground(label);
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_ESTIMATE)
+    set_battery_estimate(battery_objects[state.source].estimate, state.source, state.level);
+#endif
+
+    // 🔄 첫 값에서만 표시 (정렬과 앞뒤 순서는 생성 시 고정, 크기가 바뀌어도 LVGL이 다시 정렬)
+    if (old_level < 0) {
+        lv_obj_clear_flag(symbol, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
+    }
 }
 
 // 🔹 이벤트에서 배터리 상태 가져오기 (Peripheral)
@@ -207,46 +350,51 @@ ZMK_SUBSCRIPTION(widget_dongle_battery_status, zmk_battery_state_changed);
 int zmk_widget_dongle_battery_status_init(struct zmk_widget_dongle_battery_status *widget, lv_obj_t *parent) {
     widget->obj = lv_obj_create(parent);
 
-    int canvas_count = ZMK_SPLIT_CENTRAL_PERIPHERAL_COUNT + SOURCE_OFFSET;
-    int canvas_spacing = 46;
-    int container_width = 260;
-
-    lv_obj_set_size(widget->obj, container_width, 40);
+    lv_obj_set_size(widget->obj, CONTAINER_WIDTH, CANVAS_HEIGHT + 8 + ESTIMATE_HEIGHT);
     lv_obj_align(widget->obj, LV_ALIGN_TOP_MID, 0, 0);
 
-    int total_width = canvas_count * BATTERY_WIDTH + (canvas_count - 1) * canvas_spacing;
+    int total_width = BATTERY_COUNT * CANVAS_WIDTH + (BATTERY_COUNT - 1) * CANVAS_GAP;
 
-    for (int i = 0; i < canvas_count; i++) {
-        // 🖼 배터리 캔버스 생성
-        lv_obj_t *image_canvas = lv_canvas_create(widget->obj);
-        lv_canvas_set_buffer(image_canvas, battery_image_buffer[i], CANVAS_WIDTH, CANVAS_HEIGHT, LV_IMG_CF_TRUE_COLOR);
+    init_battery_outline(widget->obj);
 
-        // 🩶 회색빛 그림자 레이블 (먼저 생성 → 뒤쪽)
-        lv_obj_t *battery_label_shadow = lv_label_create(image_canvas);
-        lv_obj_set_style_text_font(battery_label_shadow, &NerdFonts_Regular_20, 0);
-        lv_obj_set_style_text_color(battery_label_shadow, lv_color_hex(BATTERY_SHADOW_COLOR_HEX), 0);
-        lv_obj_align(battery_label_shadow, LV_ALIGN_CENTER, 2, 2);
+    for (int i = 0; i < BATTERY_COUNT; i++) {
+        // 🖼 공유 외곽 이미지 + 막대 (레이블보다 먼저 생성 → 뒤쪽)
+        lv_obj_t *battery_image = lv_img_create(widget->obj);
+        lv_img_set_src(battery_image, &battery_outline_img);
+        lv_obj_t *bar = create_battery_bar(battery_image, layout.bar.x, layout.bar.y, layout.bar.w);
+        lv_obj_t *fill = create_battery_bar(bar, 0, 0, 0);
 
-        // 🤍 밝은 숫자 레이블 (나중 생성 → 위쪽)
-        lv_obj_t *battery_label = lv_label_create(image_canvas);
-        lv_obj_set_style_text_font(battery_label, &NerdFonts_Regular_20, 0);
+        // 🤍 밝은 숫자 레이블, 🩶 회색빛 그림자는 오른쪽 아래에 같이 그림
+        lv_obj_t *battery_label = shadow_label_create(battery_image, lv_color_hex(BATTERY_SHADOW_COLOR_HEX),
+                                                      layout.shadow_ofs, layout.shadow_ofs);
+        lv_obj_set_style_text_font(battery_label, layout.font, 0);
         lv_obj_set_style_text_color(battery_label, lv_color_hex(BATTERY_TEXT_COLOR_HEX), 0);
-        lv_obj_align(battery_label, LV_ALIGN_CENTER, 0, -1); // ⭐ 1px 위로 이동
+        lv_obj_align(battery_label, LV_ALIGN_CENTER, layout.label_ofs, layout.label_ofs); // 흰색 숫자 위치
 
         // 🔧 캔버스 배치
-        int x_offset = i * (BATTERY_WIDTH + canvas_spacing) - total_width / 2 + BATTERY_WIDTH / 2;
-        lv_obj_align(image_canvas, LV_ALIGN_CENTER, x_offset, 0);
+        int x_offset = i * (CANVAS_WIDTH + CANVAS_GAP) - total_width / 2 + CANVAS_WIDTH / 2;
+        lv_obj_align(battery_image, LV_ALIGN_CENTER, x_offset, ESTIMATE_HEIGHT / 2);
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_BATTERY_ESTIMATE)
+        // ⏳ 남은 시간 레이블 (배터리 위, 고정 폭 가운데 정렬)
+        lv_obj_t *estimate = lv_label_create(widget->obj);
+        lv_obj_set_style_text_font(estimate, &lv_font_unscii_8, 0);
+        lv_obj_set_style_text_color(estimate, lv_color_hex(BATTERY_TEXT_COLOR_HEX), 0);
+        lv_obj_set_style_text_align(estimate, LV_TEXT_ALIGN_CENTER, 0);
+        lv_obj_set_width(estimate, CANVAS_WIDTH);
+        lv_label_set_text(estimate, "");
+        lv_obj_align_to(estimate, battery_image, LV_ALIGN_OUT_TOP_MID, 0, -2);
+        battery_objects[i].estimate = estimate;
+#endif
 
-        lv_obj_add_flag(image_canvas, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(battery_image, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(battery_label, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(battery_label_shadow, LV_OBJ_FLAG_HIDDEN);
 
         // 🔹 구조체에 저장
-        battery_objects[i] = (struct battery_object){
-            .symbol = image_canvas,
-            .label = battery_label,
-            .label_shadow = battery_label_shadow
-        };
+        battery_objects[i].symbol = battery_image;
+        battery_objects[i].bar = bar;
+        battery_objects[i].fill = fill;
+        battery_objects[i].label = battery_label;
     }
 
     sys_slist_append(&widgets, &widget->node);
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+
+// 🖼 레이어 이름 이미지 (빌드 시 scripts/render_layer_labels.py가 생성, 레이어 순서)
+extern const lv_img_dsc_t layer_images[];
+extern const uint8_t layer_images_count;
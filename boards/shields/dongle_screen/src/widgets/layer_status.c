@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdio.h>
 #include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -15,6 +17,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/endpoints.h>
 #include <zmk/keymap.h>
 #include "fonts.h" // TmoneyRound_40 선언 포함
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_LAYER_IMAGES)
+#include "layer_images.h"
+#endif
+#include "../latency.h"
 
 static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
@@ -24,73 +30,144 @@ struct layer_status_state
     const char *label;
 };
 
-static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state)
+struct layer_style
 {
-    if (state.label == NULL)
-    {
-        char text[7] = {};
+    uint32_t color;
+    const char *label; // NULL: keymap layer name
+    const lv_font_t *font;
+    bool set; // false: no style for this layer
+};
 
-        sprintf(text, "%i", state.index);
+#define LAYER_STYLE_DEFAULT_COLOR 0xFFFFFF // 흰색
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_LAYER_IMAGES)
+// 이름은 빌드 시 이미지로 그려지므로 글꼴이 필요 없음
+#define LAYER_STYLE_DEFAULT_FONT NULL
+#else
+#define LAYER_STYLE_DEFAULT_FONT (&lv_font_montserrat_40)
+#endif
+
+#define LAYER_STYLES_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(zmk_dongle_screen_layer_styles)
+
+#if DT_NODE_EXISTS(LAYER_STYLES_NODE)
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_LAYER_IMAGES)
+#define LAYER_STYLE_FONT(node) NULL
+#else
+// 바인딩의 font enum 순서와 같음
+static const lv_font_t *const layer_style_fonts[] = {
+    &lv_font_montserrat_40,
+    &NerdFonts_Regular_40,
+    &NerdFonts_Regular_20,
+};
+#define LAYER_STYLE_FONT(node) layer_style_fonts[DT_ENUM_IDX(node, font)]
+#endif
+
+#define LAYER_STYLE_ENTRY(node)                                                                    \
+    [DT_PROP(node, layer)] = {                                                                     \
+        .color = DT_PROP(node, color),                                                             \
+        .label = DT_PROP_OR(node, label, NULL),                                                    \
+        .font = LAYER_STYLE_FONT(node),                                                            \
+        .set = true,                                                                               \
+    },
+
+static const struct layer_style layer_styles[] = {
+    DT_FOREACH_CHILD_STATUS_OKAY(LAYER_STYLES_NODE, LAYER_STYLE_ENTRY)};
+
+#else
+
+// 기본 레이어별 색상 (zmk,dongle-screen-layer-styles 노드가 없을 때)
+static const struct layer_style layer_styles[] = {
+    [0] = {0xFFE082, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 크림 옐로우
+    [1] = {0x0984E3, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 선명한 블루
+    [2] = {0x6C5CE7, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 보라
+    [3] = {0xFD79A8, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 핑크
+    [4] = {0xE17055, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 주황
+    [5] = {0x00CEC9, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 청록
+    [6] = {0x00B894, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 진한 민트 (원래 0번 색)
+    [7] = {0xD63031, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 빨강
+    [8] = {0x0984E3, NULL, LAYER_STYLE_DEFAULT_FONT, true}, // 선명한 블루 (반복)
+};
 
-        lv_label_set_text(label, text);
-    }
-    else
-    {
-        char text[13] = {};
+#endif
 
-        snprintf(text, sizeof(text), "%s", state.label);
+static const struct layer_style layer_style_default = {LAYER_STYLE_DEFAULT_COLOR, NULL,
+                                                       LAYER_STYLE_DEFAULT_FONT, true};
 
-        lv_label_set_text(label, text);
+static const struct layer_style *layer_style_get(uint8_t index)
+{
+    if (index < ARRAY_SIZE(layer_styles) && layer_styles[index].set)
+    {
+        return &layer_styles[index];
     }
-         // 레이어별 색상 지정
- lv_color_t color;
-    
-    switch (state.index)
+    return &layer_style_default;
+}
+
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_LAYER_IMAGES)
+
+// 미리 그린 이름 이미지를 레이어 색으로 표시 (알파 이미지는 img_recolor 색으로 그려짐)
+static void set_layer_symbol(lv_obj_t *img, struct layer_status_state state)
 {
-    case 0:
-        color = lv_color_hex(0xFFE082); // 크림 옐로우 
-        break;
-    case 1:
-        color = lv_color_hex(0x0984E3); // 선명한 블루
-        break;
-    case 2:
-        color = lv_color_hex(0x6C5CE7); // 보라
-        break;
-    case 3:
-        color = lv_color_hex(0xFD79A8); // 핑크
-        break;
-    case 4:
-        color = lv_color_hex(0xE17055); // 주황
-        break;
-    case 5:
-        color = lv_color_hex(0x00CEC9); // 청록
-        break;
-    case 6:
-        color = lv_color_hex(0x00B894); // 진한 민트 (원래 0번 색)
-        break;
-    case 7:
-        color = lv_color_hex(0xD63031); // 빨강
-        break;
-    case 8:
-        color = lv_color_hex(0x0984E3); // 선명한 블루 (반복)
-        break;
-    default:
-        color = lv_color_hex(0xFFFFFF); // 흰색
-        break;
+    const struct layer_style *style = layer_style_get(state.index);
+
+    // 이미지가 없는 레이어는 이전 레이어 이름을 남기지 않고 숨김
+    if (state.index >= layer_images_count)
+    {
+        LOG_WRN("No layer image for layer %d", state.index);
+        lv_obj_add_flag(img, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+
+    lv_img_set_src(img, &layer_images[state.index]);
+    lv_obj_set_style_img_recolor(img, lv_color_hex(style->color), 0);
+    lv_obj_clear_flag(img, LV_OBJ_FLAG_HIDDEN);
 }
 
-    // 텍스트 색상 적용
-    lv_obj_set_style_text_color(label, color, 0);
+#else
+
+// 이름 없는 레이어의 번호 (정적 텍스트용)
+static char layer_number_text[4];
+
+static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state)
+{
+    const struct layer_style *style = layer_style_get(state.index);
+
+    // 정적 텍스트: 레이어 전환 시 힙 할당/포맷 없음 (번호만 예외)
+    const char *text = style->label != NULL ? style->label : state.label;
+    if (text == NULL)
+    {
+        snprintf(layer_number_text, sizeof(layer_number_text), "%u", state.index);
+        text = layer_number_text;
+    }
+
+    lv_label_set_text_static(label, text);
+    lv_obj_set_style_text_font(label, style->font, 0);
+    lv_obj_set_style_text_color(label, lv_color_hex(style->color), 0);
 }
 
+#endif
+
 static void layer_status_update_cb(struct layer_status_state state)
 {
+    static int16_t last_index = -1;
     struct zmk_widget_layer_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_layer_symbol(widget->obj, state); }
+
+    // 같은 레이어면 건너뜀 (다른 레이어가 켜지고 꺼져도 최상위가 같을 때)
+    if (state.index != last_index)
+    {
+        last_index = state.index;
+        SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_layer_symbol(widget->obj, state); }
+    }
+    latency_mark_update(LATENCY_WIDGET_LAYER);
 }
 
 static struct layer_status_state layer_status_get_state(const zmk_event_t *eh)
 {
+    const struct zmk_layer_state_changed *ev = eh ? as_zmk_layer_state_changed(eh) : NULL;
+    if (ev)
+    {
+        latency_mark_event(LATENCY_WIDGET_LAYER, ev->timestamp);
+    }
+
     uint8_t index = zmk_keymap_highest_layer_active();
     return (struct layer_status_state){
         .index = index,
@@ -104,9 +181,13 @@ ZMK_SUBSCRIPTION(widget_layer_status, zmk_layer_state_changed);
 
 int zmk_widget_layer_status_init(struct zmk_widget_layer_status *widget, lv_obj_t *parent)
 {
+#if IS_ENABLED(CONFIG_DONGLE_SCREEN_LAYER_IMAGES)
+    widget->obj = lv_img_create(parent);
+#else
     widget->obj = lv_label_create(parent);
 
-    lv_obj_set_style_text_font(widget->obj, &lv_font_montserrat_40, 0);
+    lv_obj_set_style_text_font(widget->obj, LAYER_STYLE_DEFAULT_FONT, 0);
+#endif
 
     sys_slist_append(&widgets, &widget->node);
 
@@ -6,8 +6,10 @@
 #include <fonts.h>
 #include <zmk/display.h>
 #include <zmk/events/caps_word_state_changed.h>
+#include <zmk/events/keycode_state_changed.h>
 #include <zmk/event_manager.h>
 #include <sf_symbols.h>
+#include "../latency.h"
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -18,56 +20,110 @@ struct caps_word_indicator_state {
 };
 
 // -------------------------
-// 모디 색상 결정
-static lv_color_t mod_color(uint8_t mods) {
-    if (mods & (MOD_LCTL | MOD_RCTL)) return lv_color_hex(0xA8E6CF);
-    if (mods & (MOD_LSFT | MOD_RSFT)) return lv_color_hex(0xA8E6CF);
-    if (mods & (MOD_LALT | MOD_RALT)) return lv_color_hex(0xA8E6CF);
-    if (mods & (MOD_LGUI | MOD_RGUI)) return lv_color_hex(0x0383E6);
-    return lv_color_black();
-}
-
-// -------------------------
-// 모디 상태 업데이트
-static void update_mod_status(struct zmk_widget_mod_status *widget)
-{
-    uint8_t mods = zmk_hid_get_keyboard_report()->body.modifiers;
-    char text[32] = "";
-    int idx = 0;
+// 모디 상태 구조체 (모디 바이트 자체는 업데이트 콜백에서 읽음)
+struct mod_status_state {
+    int64_t timestamp; // 트리거한 키 이벤트 시각, 초기화 시 0
+};
 
-    char *syms[4];
-    int n = 0;
+// 전역 포인터 (단일 위젯용)
+static struct zmk_widget_mod_status *mod_status_widget_instance = NULL;
 
-    if (mods & (MOD_LCTL | MOD_RCTL)) syms[n++] = "󰘴";
-    if (mods & (MOD_LSFT | MOD_RSFT)) syms[n++] = "󰘶";
-    if (mods & (MOD_LALT | MOD_RALT)) syms[n++] = "󰘵";
-    if (mods & (MOD_LGUI | MOD_RGUI))
+// -------------------------
+// 모디 심볼 (GUI는 CONFIG_DONGLE_SCREEN_SYSTEM_ICON에 따라)
+#define MOD_SYM_CTRL "󰘴"
+#define MOD_SYM_SHIFT "󰘶"
+#define MOD_SYM_ALT "󰘵"
 #if CONFIG_DONGLE_SCREEN_SYSTEM_ICON == 1
-        syms[n++] = "󰌽";
+#define MOD_SYM_GUI "󰌽"
 #elif CONFIG_DONGLE_SCREEN_SYSTEM_ICON == 2
-        syms[n++] = "";
+#define MOD_SYM_GUI ""
 #else
-        syms[n++] = "󰘳";
+#define MOD_SYM_GUI "󰘳"
 #endif
 
-    for (int i = 0; i < n; ++i) {
-        if (i > 0) idx += snprintf(&text[idx], sizeof(text) - idx, " ");
-        idx += snprintf(&text[idx], sizeof(text) - idx, "%s", syms[i]);
-    }
+#define MOD_COLOR_KEY 0xA8E6CF // Ctrl/Shift/Alt 중 하나라도 있으면
+#define MOD_COLOR_GUI 0x0383E6 // GUI만
+
+// 조합 인덱스 비트: Ctrl 1, Shift 2, Alt 4, GUI 8 (왼쪽/오른쪽 구분 없음)
+struct mod_text {
+    const char *text;
+    uint32_t color;
+};
 
-    lv_label_set_text(widget->label, idx ? text : "");
-    lv_obj_set_style_text_color(widget->label, mod_color(mods), 0);
+// -------------------------
+// 16가지 조합의 최종 문자열과 색상 (컴파일 시 결정)
+static const struct mod_text mod_texts[16] = {
+    [0x0] = {"", 0x000000},
+    [0x1] = {MOD_SYM_CTRL, MOD_COLOR_KEY},
+    [0x2] = {MOD_SYM_SHIFT, MOD_COLOR_KEY},
+    [0x3] = {MOD_SYM_CTRL " " MOD_SYM_SHIFT, MOD_COLOR_KEY},
+    [0x4] = {MOD_SYM_ALT, MOD_COLOR_KEY},
+    [0x5] = {MOD_SYM_CTRL " " MOD_SYM_ALT, MOD_COLOR_KEY},
+    [0x6] = {MOD_SYM_SHIFT " " MOD_SYM_ALT, MOD_COLOR_KEY},
+    [0x7] = {MOD_SYM_CTRL " " MOD_SYM_SHIFT " " MOD_SYM_ALT, MOD_COLOR_KEY},
+    [0x8] = {MOD_SYM_GUI, MOD_COLOR_GUI},
+    [0x9] = {MOD_SYM_CTRL " " MOD_SYM_GUI, MOD_COLOR_KEY},
+    [0xA] = {MOD_SYM_SHIFT " " MOD_SYM_GUI, MOD_COLOR_KEY},
+    [0xB] = {MOD_SYM_CTRL " " MOD_SYM_SHIFT " " MOD_SYM_GUI, MOD_COLOR_KEY},
+    [0xC] = {MOD_SYM_ALT " " MOD_SYM_GUI, MOD_COLOR_KEY},
+    [0xD] = {MOD_SYM_CTRL " " MOD_SYM_ALT " " MOD_SYM_GUI, MOD_COLOR_KEY},
+    [0xE] = {MOD_SYM_SHIFT " " MOD_SYM_ALT " " MOD_SYM_GUI, MOD_COLOR_KEY},
+    [0xF] = {MOD_SYM_CTRL " " MOD_SYM_SHIFT " " MOD_SYM_ALT " " MOD_SYM_GUI, MOD_COLOR_KEY},
+};
+
+// HID 모디 바이트(왼쪽 하위 4비트, 오른쪽 상위 4비트) → 조합 인덱스
+static const struct mod_text *mod_text_get(uint8_t mods) {
+    return &mod_texts[(mods | (mods >> 4)) & 0x0F];
 }
 
 // -------------------------
-// 모디 상태 타이머 콜백
-static struct k_timer mod_status_timer;
-static void mod_status_timer_cb(struct k_timer *timer)
+// 모디 상태 업데이트 (문자열은 정적이라 LVGL 힙 복사 없음)
+static void update_mod_status(struct zmk_widget_mod_status *widget, const struct mod_text *entry)
 {
-    struct zmk_widget_mod_status *widget = k_timer_user_data_get(timer);
-    update_mod_status(widget);
+    lv_label_set_text_static(widget->label, entry->text);
+    lv_obj_set_style_text_color(widget->label, lv_color_hex(entry->color), 0);
+    latency_mark_update(LATENCY_WIDGET_MODS);
 }
 
+// -------------------------
+// 모디 상태 (키 이벤트 시점)
+// 이 리스너는 HID 리스너보다 먼저 불릴 수 있어 여기서는 리포트를 읽지 않음.
+// 일반 키의 암시적/명시적 모디(&kp LC(A))도 모든 키 이벤트에서 바뀔 수 있음
+static struct mod_status_state mod_status_get_state(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *ev = eh ? as_zmk_keycode_state_changed(eh) : NULL;
+
+    if (!ev) {
+        return (struct mod_status_state){ .timestamp = 0 };
+    }
+
+    latency_mark_event(LATENCY_WIDGET_MODS, ev->timestamp);
+    return (struct mod_status_state){ .timestamp = ev->timestamp };
+}
+
+// 디스플레이 스레드에서 호출, 표시할 조합이 바뀔 때만 레이블 갱신
+// 이벤트는 협조 스레드(시스템 워크 큐)에서 모든 리스너를 거친 뒤에야 이 작업이 실행되므로
+// 이 시점의 HID 리포트에는 키 이벤트가 이미 반영되어 있음
+static void mod_status_update_cb(struct mod_status_state state) {
+    static const struct mod_text *last_entry = NULL;
+    uint8_t mods = zmk_hid_get_keyboard_report()->body.modifiers;
+    const struct mod_text *entry = mod_text_get(mods);
+
+    if (!mod_status_widget_instance) return;
+    if (entry == last_entry) {
+        // 바뀐 것이 없으면 측정을 IDLE로 되돌림 (무효화가 없으면 latency.c가 리셋)
+        latency_mark_update(LATENCY_WIDGET_MODS);
+        return;
+    }
+
+    LOG_DBG("DISP | Mods 0x%02x (key event at %lld ms)", mods, state.timestamp);
+    last_entry = entry;
+    update_mod_status(mod_status_widget_instance, entry);
+}
+
+ZMK_DISPLAY_WIDGET_LISTENER(widget_mod_status, struct mod_status_state,
+                            mod_status_update_cb, mod_status_get_state)
+ZMK_SUBSCRIPTION(widget_mod_status, zmk_keycode_state_changed);
+
 // -------------------------
 // Caps Word 업데이트
 static void caps_word_indicator_set_active(lv_obj_t *label, struct caps_word_indicator_state state) {
@@ -81,15 +137,14 @@ static void caps_word_indicator_set_active(lv_obj_t *label, struct caps_word_ind
 static struct caps_word_indicator_state caps_word_indicator_get_state(const zmk_event_t *eh) {
     const struct zmk_caps_word_state_changed *ev = as_zmk_caps_word_state_changed(eh);
     LOG_INF("DISP | Caps Word State Changed: %d", ev->active);
+    latency_mark_event(LATENCY_WIDGET_CAPS_WORD, k_uptime_get());
     return (struct caps_word_indicator_state){ .active = ev->active };
 }
 
-// 전역 포인터 (단일 위젯용)
-static struct zmk_widget_mod_status *mod_status_widget_instance = NULL;
-
 static void caps_word_indicator_update_cb(struct caps_word_indicator_state state) {
     if (!mod_status_widget_instance) return;
     caps_word_indicator_set_active(mod_status_widget_instance->caps_word_label, state);
+    latency_mark_update(LATENCY_WIDGET_CAPS_WORD);
 }
 
 // -------------------------
@@ -122,10 +177,8 @@ int zmk_widget_mod_status_init(struct zmk_widget_mod_status *widget, lv_obj_t *p
     // 전역 포인터 설정
     mod_status_widget_instance = widget;
 
-    // 모디 상태 타이머
-    k_timer_init(&mod_status_timer, mod_status_timer_cb, NULL);
-    k_timer_user_data_set(&mod_status_timer, widget);
-    k_timer_start(&mod_status_timer, K_MSEC(100), K_MSEC(100));
+    // 현재 모디 상태로 초기 표시
+    widget_mod_status_init();
 
     return 0;
 }
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <lvgl.h>
+
+#include "shadow_label.h"
+
+// 그림자 색과 오프셋은 레이블의 shadow_* 스타일에 보관 (shadow_width가 0이라 상자 그림자는 그려지지 않음)
+
+// 🔹 레이블 본문보다 먼저 그림자 글자 그리기
+static void shadow_label_draw_cb(lv_event_t *e) {
+    lv_obj_t *label = lv_event_get_target(e);
+    const char *text = lv_label_get_text(label);
+    if (text == NULL || text[0] == '\0') return;
+
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    lv_obj_init_draw_label_dsc(label, LV_PART_MAIN, &dsc);
+    dsc.color = lv_obj_get_style_shadow_color(label, LV_PART_MAIN);
+
+    lv_area_t coords;
+    lv_obj_get_content_coords(label, &coords);
+    lv_area_move(&coords, lv_obj_get_style_shadow_ofs_x(label, LV_PART_MAIN),
+                 lv_obj_get_style_shadow_ofs_y(label, LV_PART_MAIN));
+
+    lv_draw_label(lv_event_get_draw_ctx(e), &dsc, &coords, text, NULL);
+}
+
+// 🔹 그림자가 레이블 밖으로 나가는 만큼 그리기/무효화 영역 확장
+static void shadow_label_ext_size_cb(lv_event_t *e) {
+    lv_obj_t *label = lv_event_get_target(e);
+    lv_coord_t ofs_x = lv_obj_get_style_shadow_ofs_x(label, LV_PART_MAIN);
+    lv_coord_t ofs_y = lv_obj_get_style_shadow_ofs_y(label, LV_PART_MAIN);
+
+    lv_event_set_ext_draw_size(e, LV_MAX(abs(ofs_x), abs(ofs_y)));
+}
+
+lv_obj_t *shadow_label_create(lv_obj_t *parent, lv_color_t shadow_color, lv_coord_t ofs_x, lv_coord_t ofs_y) {
+    lv_obj_t *label = lv_label_create(parent);
+
+    lv_obj_set_style_shadow_color(label, shadow_color, LV_PART_MAIN);
+    lv_obj_set_style_shadow_ofs_x(label, ofs_x, LV_PART_MAIN);
+    lv_obj_set_style_shadow_ofs_y(label, ofs_y, LV_PART_MAIN);
+
+    // PREPROCESS: 레이블 클래스가 본문을 그리기 전에 호출됨
+    lv_obj_add_event_cb(label, shadow_label_draw_cb, LV_EVENT_DRAW_MAIN | LV_EVENT_PREPROCESS, NULL);
+    lv_obj_add_event_cb(label, shadow_label_ext_size_cb, LV_EVENT_REFR_EXT_DRAW_SIZE, NULL);
+    lv_obj_refresh_ext_draw_size(label);
+
+    return label;
+}
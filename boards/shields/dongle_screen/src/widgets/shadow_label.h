@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+
+// 🩶 그림자 레이블: 하나의 lv_label이 같은 그리기 단계에서 글자를 두 번 그림
+// (그림자 색으로 오프셋 위치에 한 번, 그 위에 원래 색으로 한 번)
+lv_obj_t *shadow_label_create(lv_obj_t *parent, lv_color_t shadow_color, lv_coord_t ofs_x, lv_coord_t ofs_y);
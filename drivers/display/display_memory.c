@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_memory_display
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+
+#include <dongle_screen/memory_display.h>
+#ifdef CONFIG_DONGLE_SCREEN_FLUSH_HOOKS
+#include <dongle_screen/flush_hooks.h>
+#endif
+
+#include "display_memory_bottom.h"
+#include "cmdline.h"
+#include "soc.h"
+
+#define LOG_LEVEL CONFIG_DISPLAY_LOG_LEVEL
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(display_memory);
+
+/* Pixels are stored as they would be clocked out to the ST7789V: big-endian RGB565 */
+#define MEMORY_DISPLAY_PIXEL_SIZE 2u
+
+struct memory_display_config {
+	uint8_t *frame_buffer;
+	uint16_t width;
+	uint16_t height;
+};
+
+struct memory_display_data {
+	enum display_orientation orientation;
+	struct memory_display_stats stats;
+};
+
+static const char *frame_dir = CONFIG_DONGLE_SCREEN_MEMORY_DISPLAY_DUMP_DIR;
+static bool dump_every_flush = IS_ENABLED(CONFIG_DONGLE_SCREEN_MEMORY_DISPLAY_DUMP_EVERY_FLUSH);
+
+static bool memory_display_is_rotated(const struct device *dev)
+{
+	const struct memory_display_data *data = dev->data;
+
+	return data->orientation == DISPLAY_ORIENTATION_ROTATED_90 ||
+	       data->orientation == DISPLAY_ORIENTATION_ROTATED_270;
+}
+
+/* Writes arrive in the rotated coordinate space, just like on the real panel */
+static uint16_t memory_display_width(const struct device *dev)
+{
+	const struct memory_display_config *config = dev->config;
+
+	return memory_display_is_rotated(dev) ? config->height : config->width;
+}
+
+static uint16_t memory_display_height(const struct device *dev)
+{
+	const struct memory_display_config *config = dev->config;
+
+	return memory_display_is_rotated(dev) ? config->width : config->height;
+}
+
+int memory_display_dump(const struct device *dev, const char *path)
+{
+	const struct memory_display_config *config = dev->config;
+	struct memory_display_data *data = dev->data;
+	char auto_path[256];
+	int ret;
+
+	if (path == NULL) {
+		ret = memory_display_mkdir_bottom(frame_dir);
+		if (ret < 0) {
+			LOG_ERR("Couldn't create frame directory %s (%d)", frame_dir, ret);
+			return ret;
+		}
+
+		snprintf(auto_path, sizeof(auto_path), "%s/frame_%05u.ppm", frame_dir,
+			 data->stats.dumps);
+		path = auto_path;
+	}
+
+	ret = memory_display_write_ppm_bottom(path, config->frame_buffer,
+					      memory_display_width(dev),
+					      memory_display_height(dev));
+	if (ret < 0) {
+		LOG_ERR("Couldn't write frame to %s (%d)", path, ret);
+		return ret;
+	}
+
+	data->stats.dumps++;
+	LOG_DBG("Frame written to %s", path);
+
+	return 0;
+}
+
+void memory_display_get_stats(const struct device *dev, struct memory_display_stats *stats)
+{
+	const struct memory_display_data *data = dev->data;
+
+	*stats = data->stats;
+}
+
+static int memory_display_blanking_on(const struct device *dev)
+{
+	return 0;
+}
+
+static int memory_display_blanking_off(const struct device *dev)
+{
+	return 0;
+}
+
+static int memory_display_write(const struct device *dev, const uint16_t x, const uint16_t y,
+				const struct display_buffer_descriptor *desc, const void *buf)
+{
+	const struct memory_display_config *config = dev->config;
+	struct memory_display_data *data = dev->data;
+	const uint8_t *src = buf;
+	uint16_t width = memory_display_width(dev);
+
+	__ASSERT(desc->width <= desc->pitch, "Pitch is smaller then width");
+
+	if (x + desc->width > width || y + desc->height > memory_display_height(dev)) {
+		LOG_ERR("Write %dx%d @ %dx%d is out of bounds", desc->width, desc->height, x, y);
+		return -EINVAL;
+	}
+
+	LOG_DBG("Writing %dx%d (w,h) @ %dx%d (x,y)", desc->width, desc->height, x, y);
+#ifdef CONFIG_DONGLE_SCREEN_FLUSH_HOOKS
+	dongle_screen_flush_begin(dev, x, y, desc->width, desc->height);
+#endif
+
+	for (uint16_t row = 0U; row < desc->height; ++row) {
+		memcpy(&config->frame_buffer[((y + row) * width + x) * MEMORY_DISPLAY_PIXEL_SIZE],
+		       &src[row * desc->pitch * MEMORY_DISPLAY_PIXEL_SIZE],
+		       desc->width * MEMORY_DISPLAY_PIXEL_SIZE);
+	}
+
+	data->stats.flushes++;
+	data->stats.pixels += desc->width * desc->height;
+
+#ifdef CONFIG_DONGLE_SCREEN_FLUSH_HOOKS
+	dongle_screen_flush_end(dev);
+#endif
+
+	if (dump_every_flush) {
+		memory_display_dump(dev, NULL);
+	}
+
+	return 0;
+}
+
+static void memory_display_get_capabilities(const struct device *dev,
+					    struct display_capabilities *capabilities)
+{
+	const struct memory_display_config *config = dev->config;
+	const struct memory_display_data *data = dev->data;
+
+	memset(capabilities, 0, sizeof(struct display_capabilities));
+	capabilities->x_resolution = config->width;
+	capabilities->y_resolution = config->height;
+	capabilities->supported_pixel_formats = PIXEL_FORMAT_RGB_565;
+	capabilities->current_pixel_format = PIXEL_FORMAT_RGB_565;
+	capabilities->current_orientation = data->orientation;
+}
+
+static int memory_display_set_pixel_format(const struct device *dev,
+					   const enum display_pixel_format pixel_format)
+{
+	if (pixel_format == PIXEL_FORMAT_RGB_565) {
+		return 0;
+	}
+	LOG_ERR("Pixel format change not implemented");
+	return -ENOTSUP;
+}
+
+static int memory_display_set_orientation(const struct device *dev,
+					  const enum display_orientation orientation)
+{
+	struct memory_display_data *data = dev->data;
+
+	data->orientation = orientation;
+	LOG_INF("Changed orientation to: '%d'", data->orientation);
+
+	return 0;
+}
+
+static int memory_display_init(const struct device *dev)
+{
+	const struct memory_display_config *config = dev->config;
+
+	memset(config->frame_buffer, 0,
+	       config->width * config->height * MEMORY_DISPLAY_PIXEL_SIZE);
+
+	return 0;
+}
+
+static void memory_display_native_options(void)
+{
+	static struct args_struct_t memory_display_options[] = {
+		{.option = "frame-dir",
+		 .name = "path",
+		 .type = 's',
+		 .dest = (void *)&frame_dir,
+		 .descript = "Directory for dumped frames, by default "
+			     "\"" CONFIG_DONGLE_SCREEN_MEMORY_DISPLAY_DUMP_DIR "\""},
+		{.is_switch = true,
+		 .option = "dump-every-flush",
+		 .type = 'b',
+		 .dest = (void *)&dump_every_flush,
+		 .descript = "Write a PPM frame after every display flush"},
+		ARG_TABLE_ENDMARKER,
+	};
+
+	native_add_command_line_opts(memory_display_options);
+}
+
+NATIVE_TASK(memory_display_native_options, PRE_BOOT_1, 1);
+
+static const struct display_driver_api memory_display_api = {
+	.blanking_on = memory_display_blanking_on,
+	.blanking_off = memory_display_blanking_off,
+	.write = memory_display_write,
+	.get_capabilities = memory_display_get_capabilities,
+	.set_pixel_format = memory_display_set_pixel_format,
+	.set_orientation = memory_display_set_orientation,
+};
+
+#define MEMORY_DISPLAY_INIT(inst)                                                                  \
+	static uint8_t memory_display_frame_buffer_##inst[DT_INST_PROP(inst, width) *              \
+							  DT_INST_PROP(inst, height) *             \
+							  MEMORY_DISPLAY_PIXEL_SIZE];              \
+                                                                                                   \
+	static const struct memory_display_config memory_display_config_##inst = {                 \
+		.frame_buffer = memory_display_frame_buffer_##inst,                                \
+		.width = DT_INST_PROP(inst, width),                                                \
+		.height = DT_INST_PROP(inst, height),                                              \
+	};                                                                                         \
+                                                                                                   \
+	static struct memory_display_data memory_display_data_##inst = {                           \
+		.orientation = DISPLAY_ORIENTATION_NORMAL,                                         \
+	};                                                                                         \
+                                                                                                   \
+	DEVICE_DT_INST_DEFINE(inst, &memory_display_init, NULL, &memory_display_data_##inst,       \
+			      &memory_display_config_##inst, POST_KERNEL,                          \
+			      CONFIG_DISPLAY_INIT_PRIORITY, &memory_display_api);
+
+DT_INST_FOREACH_STATUS_OKAY(MEMORY_DISPLAY_INIT)
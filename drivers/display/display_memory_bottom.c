@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include "display_memory_bottom.h"
+
+int memory_display_mkdir_bottom(const char *path)
+{
+	if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+int memory_display_write_ppm_bottom(const char *path, const uint8_t *be565, int width,
+				    int height)
+{
+	FILE *file = fopen(path, "wb");
+
+	if (file == NULL) {
+		return -errno;
+	}
+
+	fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+	for (int i = 0; i < width * height; i++) {
+		uint16_t px = (uint16_t)((be565[2 * i] << 8) | be565[2 * i + 1]);
+		uint8_t rgb[3] = {
+			(uint8_t)(((px >> 11) & 0x1f) * 255 / 31),
+			(uint8_t)(((px >> 5) & 0x3f) * 255 / 63),
+			(uint8_t)((px & 0x1f) * 255 / 31),
+		};
+
+		fwrite(rgb, 1, sizeof(rgb), file);
+	}
+
+	if (fclose(file) != 0) {
+		return -errno;
+	}
+
+	return 0;
+}
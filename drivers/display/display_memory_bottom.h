@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Host side of the memory display. These functions are compiled against the
+ * host C library and must not use any Zephyr API.
+ */
+
+#ifndef DISPLAY_MEMORY_BOTTOM_H__
+#define DISPLAY_MEMORY_BOTTOM_H__
+
+#include <stdint.h>
+
+int memory_display_mkdir_bottom(const char *path);
+
+int memory_display_write_ppm_bottom(const char *path, const uint8_t *be565, int width,
+				    int height);
+
+#endif /* DISPLAY_MEMORY_BOTTOM_H__ */
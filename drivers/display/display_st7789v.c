@@ -21,6 +21,11 @@
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/drivers/display.h>
 
+#include <dongle_screen/st7789v.h>
+#ifdef CONFIG_DONGLE_SCREEN_FLUSH_HOOKS
+#include <dongle_screen/flush_hooks.h>
+#endif
+
 #define LOG_LEVEL CONFIG_DISPLAY_LOG_LEVEL
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(display_st7789v);
@@ -142,6 +147,17 @@ static int st7789v_blanking_off(const struct device *dev)
 	return 0;
 }
 
+int st7789v_set_frame_rate(const struct device *dev, uint8_t frctrl2)
+{
+	if (frctrl2 > ST7789V_FRCTRL2_39HZ) {
+		return -EINVAL;
+	}
+
+	/* Bits 7:5 (NLA) keep the default dot inversion */
+	st7789v_transmit(dev, ST7789V_CMD_FRCTRL2, &frctrl2, 1);
+	return 0;
+}
+
 static void st7789v_set_mem_area(const struct device *dev, const uint16_t x, const uint16_t y,
 				 const uint16_t w, const uint16_t h)
 {
@@ -172,6 +188,9 @@ static int st7789v_write(const struct device *dev, const uint16_t x, const uint1
 		 "Input buffer too small");
 
 	LOG_DBG("Writing %dx%d (w,h) @ %dx%d (x,y)", desc->width, desc->height, x, y);
+#ifdef CONFIG_DONGLE_SCREEN_FLUSH_HOOKS
+	dongle_screen_flush_begin(dev, x, y, desc->width, desc->height);
+#endif
 	st7789v_set_mem_area(dev, x, y, desc->width, desc->height);
 
 	if (desc->pitch > desc->width) {
@@ -189,6 +208,10 @@ static int st7789v_write(const struct device *dev, const uint16_t x, const uint1
 		write_data_start += (desc->pitch * ST7789V_PIXEL_SIZE);
 	}
 
+#ifdef CONFIG_DONGLE_SCREEN_FLUSH_HOOKS
+	dongle_screen_flush_end(dev);
+#endif
+
 	return 0;
 }
 
@@ -309,7 +332,7 @@ static void st7789v_lcd_init(const struct device *dev)
 	st7789v_transmit(dev, ST7789V_CMD_DGMEN, &tmp, 1);
 
 	/* Frame Rate Control in Normal Mode, default value */
-	tmp = 0x0f;
+	tmp = ST7789V_FRCTRL2_60HZ;
 	st7789v_transmit(dev, ST7789V_CMD_FRCTRL2, &tmp, 1);
 
 	tmp = config->gctrl;
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/device.h>
+
+/*
+ * Called by the display drivers around every display_write() when
+ * CONFIG_DONGLE_SCREEN_FLUSH_HOOKS is enabled. Both run in the context of the
+ * LVGL flush callback and must not block.
+ */
+
+/**
+ * @brief A flush of the given area is about to be sent to the panel
+ */
+void dongle_screen_flush_begin(const struct device *dev, uint16_t x, uint16_t y, uint16_t width,
+                               uint16_t height);
+
+/**
+ * @brief The last flushed area has been completely written to the panel
+ */
+void dongle_screen_flush_end(const struct device *dev);
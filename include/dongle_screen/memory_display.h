@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/device.h>
+
+/**
+ * @brief Counters kept by the memory-backed display
+ */
+struct memory_display_stats
+{
+    uint32_t flushes; // Number of display_write() calls
+    uint64_t pixels;  // Number of pixels written by all flushes
+    uint32_t dumps;   // Number of frames written to disk
+};
+
+/**
+ * @brief Write the current frame buffer content to a binary PPM (P6) file
+ *
+ * @param dev  Memory display device
+ * @param path Target file, or NULL to write the next numbered frame into the frame directory
+ * @return 0 on success, negative error code otherwise
+ */
+int memory_display_dump(const struct device *dev, const char *path);
+
+/**
+ * @brief Get a snapshot of the flush and dump counters
+ */
+void memory_display_get_stats(const struct device *dev, struct memory_display_stats *stats);
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+/*
+ * FRCTRL2 (RTNA) values for the panel frame rate in normal mode,
+ * from 0x00 (119 Hz) to 0x1F (39 Hz). 0x0F (60 Hz) is the power-on default.
+ */
+#define ST7789V_FRCTRL2_119HZ 0x00
+#define ST7789V_FRCTRL2_60HZ 0x0f
+#define ST7789V_FRCTRL2_39HZ 0x1f
+
+/**
+ * @brief Change the panel frame rate
+ *
+ * Must be called from the thread that writes to the display, a command must not be interleaved
+ * with a display_write().
+ *
+ * @param dev     ST7789V display device
+ * @param frctrl2 FRCTRL2 value, ST7789V_FRCTRL2_119HZ to ST7789V_FRCTRL2_39HZ
+ */
+int st7789v_set_frame_rate(const struct device *dev, uint8_t frctrl2);
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""Compare frames dumped by the memory display against golden images.
+
+Every golden PPM file must have a frame with the same name in the actual
+directory. A frame fails when more than --max-pixels pixels differ by more than
+--tolerance in any colour channel. For failing frames a diff image is written
+(mismatching pixels red on a dimmed copy of the golden frame).
+
+Exit code is 0 when all frames match, 1 otherwise.
+"""
+
+import argparse
+import shutil
+import sys
+from pathlib import Path
+
+
+def read_ppm(path):
+    data = path.read_bytes()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos) + 1
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    magic, width, height, maxval = fields
+    if magic != b"P6" or maxval != b"255":
+        raise ValueError(f"{path}: only binary 8-bit PPM (P6) is supported")
+    width, height = int(width), int(height)
+    pixels = data[pos + 1:pos + 1 + width * height * 3]
+    if len(pixels) != width * height * 3:
+        raise ValueError(f"{path}: truncated pixel data")
+    return width, height, pixels
+
+
+def write_ppm(path, width, height, pixels):
+    path.write_bytes(b"P6\n%d %d\n255\n" % (width, height) + bytes(pixels))
+
+
+def compare(golden, actual, tolerance):
+    gw, gh, gpx = golden
+    aw, ah, apx = actual
+    if (gw, gh) != (aw, ah):
+        return None, None
+    diff = bytearray(len(gpx))
+    mismatches = 0
+    for i in range(0, len(gpx), 3):
+        if any(abs(gpx[i + c] - apx[i + c]) > tolerance for c in range(3)):
+            mismatches += 1
+            diff[i:i + 3] = b"\xff\x00\x00"
+        else:
+            diff[i:i + 3] = bytes(v // 4 for v in gpx[i:i + 3])
+    return mismatches, diff
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("golden", type=Path, help="directory with golden PPM frames")
+    parser.add_argument("actual", type=Path, help="directory with dumped PPM frames")
+    parser.add_argument("--tolerance", type=int, default=0,
+                        help="allowed per-channel difference (default: 0)")
+    parser.add_argument("--max-pixels", type=int, default=0,
+                        help="allowed number of differing pixels per frame (default: 0)")
+    parser.add_argument("--diff-dir", type=Path,
+                        help="write diff images of failing frames into this directory")
+    parser.add_argument("--update", action="store_true",
+                        help="replace the golden frames with the actual ones")
+    args = parser.parse_args()
+
+    if args.update:
+        args.golden.mkdir(parents=True, exist_ok=True)
+        for frame in sorted(args.actual.glob("*.ppm")):
+            shutil.copyfile(frame, args.golden / frame.name)
+            print(f"updated {frame.name}")
+        return 0
+
+    goldens = sorted(args.golden.glob("*.ppm"))
+    if not goldens:
+        print(f"no golden frames in {args.golden}", file=sys.stderr)
+        return 1
+
+    failed = 0
+    for golden_path in goldens:
+        actual_path = args.actual / golden_path.name
+        if not actual_path.exists():
+            print(f"MISSING {golden_path.name}")
+            failed += 1
+            continue
+
+        golden = read_ppm(golden_path)
+        mismatches, diff = compare(golden, read_ppm(actual_path), args.tolerance)
+        if mismatches is None:
+            print(f"FAIL    {golden_path.name}: size differs")
+            failed += 1
+        elif mismatches > args.max_pixels:
+            print(f"FAIL    {golden_path.name}: {mismatches} pixels differ")
+            failed += 1
+            if args.diff_dir:
+                args.diff_dir.mkdir(parents=True, exist_ok=True)
+                write_ppm(args.diff_dir / golden_path.name, golden[0], golden[1], diff)
+        else:
+            print(f"OK      {golden_path.name}")
+
+    print(f"{len(goldens) - failed}/{len(goldens)} frames match")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
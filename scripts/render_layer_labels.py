@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""Pre-render the layer names of the keymap into LVGL 4-bit alpha images.
+
+Reads the devicetree of the build (edt.pickle), takes the text of every keymap
+layer the same way the layer widget does (label of the layer style, else the
+display-name or label of the layer, else its index) and renders it with a
+TrueType font. The images are written as a C file with one lv_img_dsc_t per
+layer in LV_IMG_CF_ALPHA_4BIT, the widget draws them in the layer colour.
+
+All images share the font's line height, so the text baseline doesn't move
+when switching layers. Needs Pillow.
+"""
+
+import argparse
+import pickle
+import sys
+from pathlib import Path
+
+from PIL import Image, ImageDraw, ImageFont
+
+
+def load_edt(path, zephyr_base):
+    # The pickle references the devicetree package of the Zephyr tree it was built with
+    sys.path.insert(0, str(Path(zephyr_base) / "scripts" / "dts" / "python-devicetree" / "src"))
+    with open(path, "rb") as f:
+        return pickle.load(f)
+
+
+def okay_children(node):
+    return [child for child in node.children.values() if child.status == "okay"]
+
+
+def prop(node, name, default=None):
+    return node.props[name].val if name in node.props else default
+
+
+def layer_texts(edt):
+    keymaps = edt.compat2okay.get("zmk,keymap", [])
+    if not keymaps:
+        raise SystemExit("no zmk,keymap node in the devicetree")
+    layers = okay_children(keymaps[0])
+
+    texts = [prop(layer, "display-name", prop(layer, "label")) for layer in layers]
+    texts = [text if text else str(index) for index, text in enumerate(texts)]
+
+    for styles in edt.compat2okay.get("zmk,dongle-screen-layer-styles", []):
+        for style in okay_children(styles):
+            index = prop(style, "layer")
+            label = prop(style, "label")
+            if label and index < len(texts):
+                texts[index] = label
+
+    return texts
+
+
+def render(text, font):
+    ascent, descent = font.getmetrics()
+    width = max(1, round(font.getlength(text)))
+    image = Image.new("L", (width, ascent + descent), 0)
+    ImageDraw.Draw(image).text((0, 0), text, font=font, fill=255)
+    return image
+
+
+def pack_alpha_4bit(image):
+    """Two pixels per byte, the left one in the high nibble, rows padded to whole bytes"""
+    width, height = image.size
+    pixels = image.load()
+    data = bytearray()
+    for y in range(height):
+        for x in range(0, width, 2):
+            high = (pixels[x, y] * 15 + 127) // 255
+            low = (pixels[x + 1, y] * 15 + 127) // 255 if x + 1 < width else 0
+            data.append(high << 4 | low)
+    return data
+
+
+def write_c(path, texts, images):
+    lines = [
+        "/*",
+        " * Generated by scripts/render_layer_labels.py, do not edit",
+        " */",
+        "",
+        "#include <lvgl.h>",
+        "",
+        '#include "layer_images.h"',
+        "",
+    ]
+
+    for index, (text, image) in enumerate(zip(texts, images)):
+        data = pack_alpha_4bit(image)
+        lines.append(f"// {index}: {text!r}")
+        lines.append(f"static const uint8_t layer_image_{index}_map[] = {{")
+        for offset in range(0, len(data), 16):
+            lines.append("    " + ", ".join(f"0x{b:02x}" for b in data[offset:offset + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append("const lv_img_dsc_t layer_images[] = {")
+    for index, image in enumerate(images):
+        width, height = image.size
+        lines += [
+            "    {",
+            "        .header.cf = LV_IMG_CF_ALPHA_4BIT,",
+            f"        .header.w = {width},",
+            f"        .header.h = {height},",
+            f"        .data_size = sizeof(layer_image_{index}_map),",
+            f"        .data = layer_image_{index}_map,",
+            "    },",
+        ]
+    lines.append("};")
+    lines.append("")
+    lines.append(f"const uint8_t layer_images_count = {len(images)};")
+    lines.append("")
+
+    path.write_text("\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--edt-pickle", type=Path, required=True, help="edt.pickle of the build")
+    parser.add_argument("--zephyr-base", type=Path, required=True, help="Zephyr tree of the build")
+    parser.add_argument("--font", type=Path, required=True, help="TrueType font to render with")
+    parser.add_argument("--size", type=int, default=40, help="font size in pixels")
+    parser.add_argument("--output", type=Path, required=True, help="C file to write")
+    args = parser.parse_args()
+
+    texts = layer_texts(load_edt(args.edt_pickle, args.zephyr_base))
+    font = ImageFont.truetype(str(args.font), args.size)
+    images = [render(text, font) for text in texts]
+
+    write_c(args.output, texts, images)
+    total = sum((image.size[0] + 1) // 2 * image.size[1] for image in images)
+    print(f"render_layer_labels: {len(images)} layer images, {total} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+
+"""Convert the output of "dongle_screen trace dump" into a binary event trace.
+
+Reads a captured console/log file, collects all "trace: <hex>" lines and writes
+the decoded bytes. With --print the records are listed in readable form.
+"""
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+
+TYPES = ["delay", "keycode", "layer", "wpm", "modifiers", "battery", "endpoint", "caps_word"]
+HEADER_SIZE = 8
+RECORD_SIZE = 6
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("log", type=Path, help="captured shell output")
+    parser.add_argument("output", type=Path, help="binary trace to write")
+    parser.add_argument("--print", action="store_true", help="list the decoded records")
+    args = parser.parse_args()
+
+    data = bytearray()
+    for line in args.log.read_text(errors="replace").splitlines():
+        match = re.search(r"trace: ([0-9a-fA-F]+)\s*$", line)
+        if match:
+            data += bytes.fromhex(match.group(1))
+
+    if data[:4] != b"DSTR":
+        print("no trace found in log", file=sys.stderr)
+        return 1
+
+    args.output.write_bytes(data)
+    count = (len(data) - HEADER_SIZE) // RECORD_SIZE
+    print(f"wrote {count} records to {args.output}")
+
+    if args.print:
+        t = 0
+        for offset in range(HEADER_SIZE, HEADER_SIZE + count * RECORD_SIZE, RECORD_SIZE):
+            dt, kind, arg, value = struct.unpack_from("<HBBH", data, offset)
+            t += dt
+            name = TYPES[kind] if kind < len(TYPES) else f"type{kind}"
+            print(f"{t:10d} ms  {name:10s} arg=0x{arg:02x} value={value}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())